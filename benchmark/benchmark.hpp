@@ -0,0 +1,45 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include "../include/syntax_tree/ast.hpp"
+#include <chrono>
+#include <ratio>
+#include <string>
+#include <vector>
+
+/** @brief
+ * Tree builders and the timer shared by the benchmarks, each of which is its own executable.
+ */
+
+inline Node* op(const std::string& name, Node* left, Node* right) {
+    return new Node(Token::TokenData(Token::OPERATOR, name), left, right);
+}
+
+inline Node* function(const std::string& name, Node* argument) {
+    return new Node(Token::TokenData(Token::FUNCTION, name), argument, nullptr);
+}
+
+inline Node* leaf(Token::TokenType type, const std::string& value) {
+    return new Node(Token::TokenData(type, value));
+}
+
+/** @brief Variables v0 .. v(dimension-1): their names go to variables, their leaves are returned */
+inline std::vector<Node*> variableLeaves(size_t dimension, std::vector<std::string>& variables) {
+    std::vector<Node*> leaves;
+    for (size_t i = 0; i < dimension; ++i) {
+        variables.push_back("v" + std::to_string(i));
+        leaves.push_back(leaf(Token::VARIABLE, variables.back()));
+    }
+    return leaves;
+}
+
+/** @brief Average time of evaluate(i) for i = 0 .. repetitions-1, in Unit (std::milli, std::micro, ...) seconds */
+template <typename Unit = std::milli, typename Evaluate>
+double timePerCall(Evaluate evaluate, int repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i) evaluate(i);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, Unit>(stop - start).count() / repetitions;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#include "./benchmark.hpp"
+#include "../include/numerical/prepared_problem.hpp"
+#include "../include/numerical/hessian_assembler.hpp"
+#include <chrono>
+#include <iomanip>
+
+/** @brief
+ * Dense Hessian of a wide, coupled objective: all n^2 entries compiled into one program
+ * (PreparedProblem) against the upper triangle assembled on pools of growing size.
+ */
+
+int main() {
+    const size_t dimension = 120;
+    std::vector<std::string> variables;
+    std::vector<Node*> leaves = variableLeaves(dimension, variables);
+
+    // sin(v_i) * v_{i+1}^2 + cos(v_i * v_{i+3}): a banded Hessian with every row non-trivial
+    Node* sum = nullptr;
+    for (size_t i = 0; i < dimension; ++i) {
+        Node* a = leaves[i];
+        Node* b = leaves[(i + 1) % dimension];
+        Node* c = leaves[(i + 3) % dimension];
+        Node* term = op("+", op("*", function("sin", a), op("^", b, leaf(Token::NUMBER, "2"))),
+                             function("cos", op("*", a, c)));
+        sum = sum ? op("+", sum, term) : term;
+    }
+
+    std::vector<double> x(dimension);
+    for (size_t i = 0; i < dimension; ++i) x[i] = 0.01 * i - 0.3;
+
+    auto start = std::chrono::steady_clock::now();
+    PreparedProblem eager(sum, variables, true);
+    double eagerPreparation = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> reference(dimension, dimension);
+    double eagerTime = timePerCall([&](int) { eager.hessian(x.data(), reference.data()); }, 200);
+
+    std::cout << std::fixed << std::setprecision(3) << "n = " << dimension << "\n"
+              << std::setw(22) << "" << std::setw(14) << "prepare (ms)" << std::setw(14) << "assemble (ms)" << std::setw(12) << "|error|" << "\n"
+              << std::setw(22) << "all n^2 entries" << std::setw(14) << eagerPreparation << std::setw(14) << eagerTime << "\n";
+
+    PreparedProblem problem(sum, variables);
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t workers : {size_t(1), size_t(2), size_t(4), hardware}) {
+        ThreadPool pool(workers);
+        HessianAssembler assembler(problem, pool);
+        Eigen::MatrixXd hessian;
+        double assemblyTime = timePerCall([&](int) { assembler.assemble(x.data(), hessian); }, 200);
+        double error = (hessian - Eigen::MatrixXd(reference)).cwiseAbs().maxCoeff();
+        std::cout << std::setw(13) << "upper, " << std::setw(2) << workers << " workers"
+                  << std::setw(14) << 1000.0 * assembler.timing().preparationSeconds << std::setw(14) << assemblyTime
+                  << std::scientific << std::setprecision(1) << std::setw(12) << error << std::fixed << std::setprecision(3) << "\n";
+    }
+    return 0;
+}
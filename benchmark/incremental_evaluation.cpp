@@ -0,0 +1,113 @@
+#include "./benchmark.hpp"
+#include "../include/numerical/program.hpp"
+#include "../include/numerical/incremental_evaluator.hpp"
+#include <cmath>
+#include <iomanip>
+
+/** @brief
+ * One coordinate changed at a time on a separable objective: IncrementalEvaluator against a
+ * full Program run. Before timing, outputs that are also terms of another output's sum, e.g.
+ * a+b and (a+b)+c, are checked against full runs: the shared slot must stay up to date. So
+ * are terms that go to infinity and back, or drop from 1e20 to 1: the sums must not stay NaN
+ * or lose their small terms until the next refresh.
+ */
+
+// Largest difference between the evaluator's outputs and a full run at its current point
+static double outputError(const Program& program, const IncrementalEvaluator& incremental) {
+    std::vector<double> values, outputs(program.outputs().size());
+    program.evaluate(incremental.point().data(), values, outputs.data());
+    double error = 0.0;
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        // fmax would drop a NaN output, so count it as an infinite difference
+        double difference = outputs[k] == incremental.output(k) ? 0.0 : std::fabs(outputs[k] - incremental.output(k));
+        error = std::isnan(difference) ? INFINITY : std::fmax(error, difference);
+    }
+    return error;
+}
+
+int main() {
+    {
+        std::vector<std::string> variables;
+        std::vector<Node*> v = variableLeaves(3, variables);
+        Node* ab = op("+", op("*", v[0], v[1]), function("sin", v[1]));
+        Program shared({op("+", ab, v[2]), ab}, variables);
+        IncrementalEvaluator incremental(shared);
+        const double x[3] = {0.5, -1.0, 2.0};
+        incremental.bind(x);
+        incremental.set(1, 0.25);
+        incremental.evaluate();
+        incremental.set(2, -3.0);
+        incremental.evaluate();
+        double error = outputError(shared, incremental);
+        if (error > 1e-12) {
+            std::cout << "outputs sharing a sum: incremental differs from a full run by " << error << "\n";
+            return 1;
+        }
+    }
+
+    {
+        // 1/x + x^2 + y: 1/x is inf at 0, x^2 is 1e20 at 1e10, y stays small
+        std::vector<std::string> variables;
+        std::vector<Node*> v = variableLeaves(2, variables);
+        Program sum(op("+", op("+", op("/", leaf(Token::NUMBER, "1"), v[0]), op("^", v[0], leaf(Token::NUMBER, "2"))), v[1]),
+                    variables);
+        IncrementalEvaluator incremental(sum);
+        const double x[2] = {1.0, 1e-3};
+        incremental.bind(x);
+        const double path[3] = {0.0, 1e10, 0.5};
+        for (double value : path) {
+            incremental.set(0, value);
+            incremental.evaluate();
+        }
+        double error = outputError(sum, incremental);
+        if (!(error <= 1e-12)) {
+            std::cout << "terms through inf and 1e20: incremental differs from a full run by " << error << "\n";
+            return 1;
+        }
+    }
+
+    const size_t dimension = 2000;
+    std::vector<std::string> variables;
+    std::vector<Node*> leaves = variableLeaves(dimension, variables);
+
+    // sum of sin(v_i) * v_{i+1}^2 + (v_i - v_{i+2})^2, added pairwise to keep the tree shallow
+    std::vector<Node*> level;
+    for (size_t i = 0; i < dimension; ++i) {
+        Node* a = leaves[i];
+        Node* b = leaves[(i + 1) % dimension];
+        Node* c = leaves[(i + 2) % dimension];
+        level.push_back(op("+", op("*", function("sin", a), op("^", b, leaf(Token::NUMBER, "2"))),
+                                op("^", op("-", a, c), leaf(Token::NUMBER, "2"))));
+    }
+    while (level.size() > 1) {
+        std::vector<Node*> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) next.push_back(op("+", level[i], level[i + 1]));
+        if (level.size() % 2) next.push_back(level.back());
+        level = next;
+    }
+
+    Program program(level[0], variables);
+    IncrementalEvaluator incremental(program);
+    std::vector<double> x(dimension), values;
+    for (size_t i = 0; i < dimension; ++i) x[i] = 0.001 * i;
+    incremental.bind(x.data());
+
+    size_t recomputed = 0;
+    double incrementalTime = timePerCall<std::micro>([&](int i) {
+        size_t k = i % dimension;
+        incremental.set(k, incremental.point()[k] + 1e-3);
+        incremental.evaluate();
+        recomputed += incremental.recomputed();
+    }, 100000);
+    double fullTime = timePerCall<std::micro>([&](int i) {
+        x[i % dimension] += 1e-3;
+        program.evaluate(x.data(), values);
+    }, 2000);
+
+    std::cout << std::fixed << std::setprecision(3) << "n = " << dimension << ", slots: " << program.size() << "\n"
+              << "full program:     " << fullTime << " us per coordinate change\n"
+              << "incremental:      " << incrementalTime << " us per coordinate change ("
+              << recomputed / 100000.0 << " slots recomputed)\n"
+              << "largest difference: " << std::scientific << outputError(program, incremental) << "\n";
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "./benchmark.hpp"
+#include "../include/numerical/program.hpp"
+#include "../include/numerical/parallel_evaluator.hpp"
+#include <iomanip>
+
+/** @brief
+ * Objective, gradient and Hessian-vector product of a large sum on pools of growing size,
+ * against a single compiled Program for the objective.
+ */
+
+int main() {
+    const size_t dimension = 1000, terms = 40000;
+    std::vector<std::string> variables;
+    std::vector<Node*> leaves = variableLeaves(dimension, variables);
+
+    // sum of sin(a) * b^2 + cos(0.001 * a * c) over neighbouring variables, added pairwise so
+    // the recursive compilers do not run out of stack on one very deep chain
+    std::vector<Node*> level;
+    for (size_t t = 0; t < terms; ++t) {
+        Node* a = leaves[t % dimension];
+        Node* b = leaves[(t + 1) % dimension];
+        Node* c = leaves[(t + 7) % dimension];
+        Node* term = op("+", op("*", function("sin", a), op("^", b, leaf(Token::NUMBER, "2"))),
+                             function("cos", op("*", leaf(Token::NUMBER, "0.001"), op("*", a, c))));
+        level.push_back(term);
+    }
+    while (level.size() > 1) {
+        std::vector<Node*> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) next.push_back(op(i % 3 ? "+" : "-", level[i], level[i + 1]));
+        if (level.size() % 2) next.push_back(level.back());
+        level = next;
+    }
+    Node* sum = level[0];
+
+    std::vector<double> x(dimension), v(dimension), g(dimension), hv(dimension), values;
+    for (size_t i = 0; i < dimension; ++i) { x[i] = 0.001 * i; v[i] = 1.0 - 0.0005 * i; }
+
+    Program serial(sum, variables);
+    double serialTime = timePerCall([&](int) { serial.evaluate(x.data(), values); }, 50);
+    std::cout << "nodes: " << ParallelEvaluator::nodeCount(sum) << ", single program: " << std::fixed
+              << std::setprecision(3) << serialTime << " ms per objective\n\n";
+
+    std::cout << std::setw(8) << "workers" << std::setw(8) << "chunks" << std::setw(12) << "f (ms)"
+              << std::setw(12) << "grad (ms)" << std::setw(12) << "Hv (ms)" << std::setw(12) << "|f error|" << "\n";
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t workers : {size_t(1), size_t(2), size_t(4), hardware}) {
+        ThreadPool pool(workers);
+        ParallelEvaluator parallel(sum, variables, pool);
+        double valueTime = timePerCall([&](int) { parallel.value(x.data()); }, 50);
+        double gradientTime = timePerCall([&](int) { parallel.gradient(x.data(), g.data()); }, 50);
+        double productTime = timePerCall([&](int) { parallel.hessianVector(x.data(), v.data(), hv.data()); }, 50);
+        double error = std::fabs(parallel.value(x.data()) - serial.evaluate(x.data(), values));
+        std::cout << std::setw(8) << workers << std::setw(8) << parallel.chunks() << std::setw(12) << valueTime
+                  << std::setw(12) << gradientTime << std::setw(12) << productTime
+                  << std::scientific << std::setprecision(1) << std::setw(12) << error
+                  << std::fixed << std::setprecision(3) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "./benchmark.hpp"
+#include "../include/numerical/prepared_problem.hpp"
+#include "../include/numerical/evaluation_context.hpp"
+#include <iomanip>
+
+/** @brief
+ * f, grad f and the Hessian at the same point: three separate programs (PreparedProblem)
+ * against one EvaluationContext that shares their common subexpressions.
+ */
+
+int main() {
+    const size_t dimension = 12;
+    std::vector<std::string> variables;
+    std::vector<Node*> leaves = variableLeaves(dimension, variables);
+    // sin(v_i * v_{i+1}) * cos(v_{i+2}) + (v_i - v_{i+1})^4: trigonometric terms reappear in every derivative
+    Node* sum = nullptr;
+    for (size_t i = 0; i < dimension; ++i) {
+        Node* a = leaves[i];
+        Node* b = leaves[(i + 1) % dimension];
+        Node* c = leaves[(i + 2) % dimension];
+        Node* term = op("+", op("*", function("sin", op("*", a, b)), function("cos", c)),
+                             op("^", op("-", a, b), leaf(Token::NUMBER, "4")));
+        sum = sum ? op("+", sum, term) : term;
+    }
+
+    PreparedProblem problem(sum, variables, true);
+    EvaluationContext context(problem);
+    std::vector<double> x(dimension), g(dimension), h(dimension * dimension);
+    auto move = [&](int i) { for (size_t k = 0; k < dimension; ++k) x[k] = 0.1 * k + 1e-7 * i; };
+
+    double separate = timePerCall<std::micro>([&](int i) {
+        move(i);
+        problem.value(x.data());
+        problem.gradient(x.data(), g.data());
+        problem.hessian(x.data(), h.data());
+    }, 20000);
+    double shared = timePerCall<std::micro>([&](int i) {
+        move(i);
+        context.setPoint(x.data());
+        context.value();
+        context.gradient(g.data());
+        context.hessian(h.data());
+    }, 20000);
+
+    // Same numbers either way
+    std::vector<double> g2(dimension), h2(dimension * dimension);
+    double error = std::fabs(context.value(x.data()) - problem.value(x.data()));
+    context.gradient(g2.data());
+    context.hessian(h2.data());
+    problem.gradient(x.data(), g.data());
+    problem.hessian(x.data(), h.data());
+    for (size_t k = 0; k < dimension; ++k) error = std::max(error, std::fabs(g[k] - g2[k]));
+    for (size_t k = 0; k < dimension * dimension; ++k) error = std::max(error, std::fabs(h[k] - h2[k]));
+
+    const EvaluationContext::Statistics& statistics = context.statistics();
+    std::cout << std::fixed << std::setprecision(3)
+              << "slots: f " << problem.objectiveProgram().size() << ", grad " << problem.gradientProgram().size()
+              << ", Hessian " << problem.hessianProgram().size() << "\n"
+              << "separate programs: " << separate << " us per point\n"
+              << "shared context:    " << shared << " us per point (" << statistics.reused << " slot values reused, "
+              << statistics.computed << " computed)\n"
+              << "largest difference: " << std::scientific << error << "\n";
+    return 0;
+}
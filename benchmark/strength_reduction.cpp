@@ -0,0 +1,87 @@
+#include "../include/tokenize/token.hpp"
+#include "./benchmark.hpp"
+#include "../include/syntax_tree/differentiator.hpp"
+#include "../include/numerical/program.hpp"
+#include <iomanip>
+
+/** @brief
+ * Per-evaluation cost of the same expressions with and without the strength reduction pass
+ * (Lowering::lower), next to the original Token::evaluateRPN path.
+ */
+
+static Node* parse(const std::string& expression) {
+    Token tokenizer;
+    AST ast;
+    return ast.buildAST(tokenizer.ShuntingYard(tokenizer.tokenize(expression)));
+}
+
+// Postorder of the tree is its RPN
+static void toQueue(Node* node, std::queue<Token::TokenData>& queue) {
+    if (!node) return;
+    toQueue(node->left, queue);
+    toQueue(node->right, queue);
+    queue.push(node->data);
+}
+
+template <typename Evaluate>
+static double nanosecondsPerEvaluation(Evaluate evaluate, int repetitions) {
+    volatile double sink = 0.0;
+    return timePerCall<std::nano>([&](int i) { sink = sink + evaluate(0.5 + 1e-6 * i, 1.5 - 1e-6 * i); }, repetitions);
+}
+
+static void benchmark(const std::string& name, Node* expression) {
+    const std::vector<std::string> variables = {"x", "y"};
+    Token tokenizer;
+    std::queue<Token::TokenData> rpn;
+    toQueue(expression, rpn);
+    Program plain(expression, variables, false);
+    Program lowered(expression, variables, true);
+    std::vector<double> values;
+
+    double rpnTime = nanosecondsPerEvaluation([&](double x, double y) {
+        return tokenizer.evaluateRPN(rpn, {{"x", x}, {"y", y}});
+    }, 20000);
+    double plainTime = nanosecondsPerEvaluation([&](double x, double y) {
+        double point[2] = {x, y};
+        return plain.evaluate(point, values);
+    }, 2000000);
+    double loweredTime = nanosecondsPerEvaluation([&](double x, double y) {
+        double point[2] = {x, y};
+        return lowered.evaluate(point, values);
+    }, 2000000);
+
+    double point[2] = {0.7, 1.3};
+    double difference = std::fabs(plain.evaluate(point, values) - lowered.evaluate(point, values));
+
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << rpnTime << std::setw(10) << plainTime << std::setw(10) << loweredTime
+              << std::setw(9) << std::setprecision(2) << plainTime / loweredTime << "x"
+              << std::setw(4) << plain.size() << " -> " << std::setw(3) << lowered.size()
+              << std::scientific << std::setprecision(1) << std::setw(10) << difference << "\n";
+}
+
+int main() {
+    Differentiator differentiator;
+    const std::vector<std::string> expressions = {
+        "(x-1)^2 + (y-2)^2",
+        "x^3*y^2 + x^4 - 3*y^3",
+        "(x+y)^6 - x^5*y",
+        "x/4 + y/8 + (x*y)^0.5",
+        "(x^2 + y^2)^-0.5",
+    };
+
+    std::cout << std::left << std::setw(34) << "expression (ns per evaluation)" << std::right
+              << std::setw(10) << "RPN" << std::setw(10) << "tape" << std::setw(10) << "lowered"
+              << std::setw(10) << "speedup" << std::setw(11) << "slots" << std::setw(10) << "|error|" << "\n";
+
+    for (const std::string& expression : expressions) {
+        Node* objective = parse(expression);
+        benchmark(expression, objective);
+        // The power rule output, e.g. 2 * (x - 1) ^ (2 - 1), is where most of the x^n come from
+        benchmark("  d/dx", differentiator.simplify(differentiator.differentiate(objective, "x")));
+    }
+
+    Node* exponentials = op("*", function("exp", parse("x*y")), function("exp", parse("x-y")));
+    benchmark("exp(x*y) * exp(x-y)", exponentials);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef BFGS_HPP
+#define BFGS_HPP
+
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/line_restriction.hpp"
+#include "./more_thuente_line_search.hpp"
+#include "../Eigen/Dense"
+#include <map>
+#include <string>
+#include <iostream>
+
+/** @brief
+ * Dense BFGS for medium sized problems. The Hessian approximation B = L L^T is kept only as
+ * its Cholesky factor: the BFGS update B + y y^T / (y.s) - (Bs)(Bs)^T / (s.Bs) is applied to
+ * L as one rank-one update and one rank-one downdate (LLT::rankUpdate), and the direction
+ * solves B d = -g with the factor. Every iteration is O(n^2), nothing is inverted and no
+ * second derivative is evaluated.
+ */
+class BFGS {
+    public:
+        BFGS(
+            const PreparedProblem& problem,
+            std::map<std::string, double> x0,
+            double tolerance = 1e-6,
+            size_t maxIterations = 1000
+        );
+        ~BFGS();
+        /** @brief Iterate until ||g|| <= tolerance, the line search stalls or maxIterations */
+        virtual void _run();
+
+        /** @brief Replace the default Moré-Thuente search; lineSearch must outlive the solver */
+        void setLineSearch(const LineSearch& lineSearch);
+
+        /** @brief Last iterate, in the order of the problem's variables */
+        const Eigen::VectorXd& solution() const;
+        size_t iterations() const;
+        /** @brief Trial steps of the line searches, each one value and one gradient */
+        size_t evaluations() const;
+        /** @brief Times the factor was reset to a scaled identity after a failed downdate */
+        size_t resets() const;
+
+    private:
+        const PreparedProblem& m_problem;
+        LineRestriction m_line;
+        MoreThuenteLineSearch m_defaultLineSearch;
+        const LineSearch* m_lineSearch;
+        double m_tolerance;
+        size_t m_maxIterations;
+        Eigen::VectorXd m_x;
+        Eigen::LLT<Eigen::MatrixXd> m_factor; // B = L L^T
+        size_t m_iterations;
+        size_t m_evaluations;
+        size_t m_resets;
+
+        void resetFactor(double scale);
+};
+
+#endif
@@ -2,6 +2,10 @@
 #define CONJUGATE_GRADIENT_HPP
 
 #include "../syntax_tree/differentiator.hpp"
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/line_restriction.hpp"
+#include "./line_search.hpp"
+#include "./exact_line_search.hpp"
 #include "../syntax_tree/ast.hpp"
 #include "../tokenize/token.hpp"
 #include "../Eigen/Dense"
@@ -13,33 +17,41 @@ class Conjugate_Gradient : public Differentiator{
     public:
         //Constructor
         Conjugate_Gradient(
-            Node* function,
-            std::string expression,
+            const PreparedProblem& problem,
             std::map<std::string, double> x0,
-            double tolerance
+            double tolerance,
+            size_t maxIterations = 10000
         );
         // Destructor
         ~Conjugate_Gradient();
-        // run method
+        /** @brief Fletcher-Reeves, then Polak-Ribiere, each until ||g|| <= tolerance, the step stalls or maxIterations */
         virtual void _run();
+        /** @brief Use lineSearch instead of the exact step or Brent's method; it must outlive the solver */
+        void setLineSearch(const LineSearch& lineSearch);
 
     private:
-        Node* m_function;
-        std::map<std::string, double> x_new; // new x
-        std::map<std::string, double> x_curr; // current x
+        const PreparedProblem& m_problem;
+        LineRestriction m_line;
+        const LineSearch* m_lineSearch; // nullptr: m_exact for polynomials, Brent otherwise
+        ExactLineSearch m_exact;
+        Eigen::VectorXd x_new; // new x, in the order of the problem's variables
+        Eigen::VectorXd x_curr; // current x
         double BETA_Fletcher_Reeves;
         double BETA_Polak_Ribiere;
-        Eigen::MatrixXd d_old;
-        Eigen::MatrixXd d_new;
-        Eigen::MatrixXd dir_k;
+        Eigen::VectorXd d_old; // previous gradient
+        Eigen::VectorXd d_new;
+        Eigen::VectorXd dir_k;
         double step;
         double m_tolerance;
+        size_t m_maxIterations;
         double a;
         double b;
-        std::string m_expression;
         Differentiator differentiator;
         Token tokenizer;
-        double solve_for_step_2nd_order(std::string& s_expression);
+        /** @brief Restrict the objective to the line x + s*direction */
+        void restrict_to_line(const Eigen::VectorXd& x, const Eigen::VectorXd& direction);
+        /** @brief Step along direction from x, restarting along -gradient if direction does not descend */
+        double line_step(const Eigen::VectorXd& x, const Eigen::VectorXd& gradient, Eigen::VectorXd& direction);
         virtual void Solver_Fletcher_Reeves();
         virtual void Solver_Polak_Ribiere();
 };
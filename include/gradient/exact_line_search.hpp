@@ -0,0 +1,40 @@
+#ifndef EXACT_LINE_SEARCH_HPP
+#define EXACT_LINE_SEARCH_HPP
+
+#include "./line_search.hpp"
+#include "./more_thuente_line_search.hpp"
+#include "../numerical/prepared_problem.hpp"
+#include "../Eigen/Dense"
+#include <vector>
+
+/** @brief
+ * Exact line steps for polynomial objectives. If f is a polynomial of degree k (found
+ * symbolically, through Polynomial::fromAST), phi(s) = f(x + s*d) is a polynomial of degree
+ * at most k in s. Its coefficients follow from phi(0), phi'(0) and k-1 more evaluations; the
+ * real roots of phi' are the eigenvalues of its companion matrix, and the step is the lowest
+ * of the local minimizers among them. The step is checked with one more evaluation, which
+ * also leaves the line's gradient at the step.
+ * Objectives that are not polynomials (or of a degree above maxDegree), and lines along which
+ * phi has no minimizer, go to a Moré-Thuente search instead.
+ */
+class ExactLineSearch : public LineSearch {
+    public:
+        explicit ExactLineSearch(const PreparedProblem& problem, int maxDegree = 8);
+
+        /** @brief initialStep only sets the scale of the sample points */
+        Result search(LineRestriction& line, double value, double slope, double initialStep = 1.0) const override;
+
+        /** @brief true when the objective is a polynomial the exact step applies to */
+        bool applicable() const;
+        /** @brief Degree of the objective, -1 if it is not a polynomial */
+        int degree() const;
+        /** @brief Real roots of sum_i coefficients[i] * s^i, from the real Schur form of the companion matrix */
+        static std::vector<double> realRoots(const Eigen::VectorXd& coefficients);
+
+    private:
+        int m_degree;
+        int m_maxDegree;
+        MoreThuenteLineSearch m_fallback;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef LBFGS_HPP
+#define LBFGS_HPP
+
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/line_restriction.hpp"
+#include "./more_thuente_line_search.hpp"
+#include "../Eigen/Dense"
+#include <map>
+#include <string>
+#include <iostream>
+
+/** @brief
+ * Limited-memory BFGS. The inverse Hessian approximation is never formed: the last m
+ * curvature pairs s_k = x_{k+1} - x_k, y_k = g_{k+1} - g_k are kept in two n x m matrices
+ * (a ring buffer of columns) and the search direction comes from the two-loop recursion.
+ * Memory and the work per iteration are O(mn), and only gradients are evaluated.
+ */
+class LBFGS {
+    public:
+        LBFGS(
+            const PreparedProblem& problem,
+            std::map<std::string, double> x0,
+            size_t memory = 10,
+            double tolerance = 1e-6,
+            size_t maxIterations = 1000
+        );
+        ~LBFGS();
+        /** @brief Iterate until ||g|| <= tolerance, the line search stalls or maxIterations */
+        virtual void _run();
+
+        /** @brief Replace the default Moré-Thuente search; lineSearch must outlive the solver */
+        void setLineSearch(const LineSearch& lineSearch);
+
+        /** @brief Last iterate, in the order of the problem's variables */
+        const Eigen::VectorXd& solution() const;
+        size_t iterations() const;
+        /** @brief Trial steps of the line searches, each one value and one gradient */
+        size_t evaluations() const;
+
+    private:
+        const PreparedProblem& m_problem;
+        LineRestriction m_line;
+        MoreThuenteLineSearch m_defaultLineSearch;
+        const LineSearch* m_lineSearch;
+        size_t m_memory;
+        double m_tolerance;
+        size_t m_maxIterations;
+        Eigen::VectorXd m_x;
+        Eigen::MatrixXd m_S; // column k % m holds s_k
+        Eigen::MatrixXd m_Y; // column k % m holds y_k
+        Eigen::VectorXd m_rho; // 1 / (y_k . s_k)
+        Eigen::VectorXd m_alpha; // two-loop scratch
+        size_t m_pairs; // curvature pairs stored so far
+        size_t m_iterations;
+        size_t m_evaluations;
+
+        /** @brief d = -H g by the two-loop recursion */
+        void direction(const Eigen::VectorXd& gradient, Eigen::VectorXd& d);
+};
+
+#endif
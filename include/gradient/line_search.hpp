@@ -0,0 +1,41 @@
+#ifndef LINE_SEARCH_HPP
+#define LINE_SEARCH_HPP
+
+#include "../numerical/line_restriction.hpp"
+
+/** @brief
+ * Interface of the line searches the gradient solvers can be given (setLineSearch).
+ * A search gets phi(s) = f(x + s*d) as a LineRestriction set to the current line, with
+ * phi(0) and phi'(0) < 0 already known, and returns the accepted step.
+ */
+class LineSearch {
+    public:
+        struct Result {
+            double step;        // 0 when no acceptable step was found
+            double value;       // phi(step)
+            double slope;       // phi'(step), if hasGradient
+            size_t evaluations; // trial steps
+            bool converged;     // false: the best step found within the evaluation budget
+            bool hasGradient;   // the line's gradient() is the gradient at step
+        };
+
+        virtual ~LineSearch() {}
+        virtual Result search(LineRestriction& line, double value, double slope, double initialStep = 1.0) const = 0;
+};
+
+/** @brief
+ * Armijo backtracking: the step is halved until phi(s) <= phi(0) + c1*s*phi'(0).
+ * Only values are evaluated, the right choice for Newton steps whose length is already right.
+ */
+class BacktrackingLineSearch : public LineSearch {
+    public:
+        BacktrackingLineSearch(double c1 = 1e-4, double shrink = 0.5, double minStep = 1e-12);
+        Result search(LineRestriction& line, double value, double slope, double initialStep = 1.0) const override;
+
+    private:
+        double m_c1;
+        double m_shrink;
+        double m_minStep;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef MORE_THUENTE_LINE_SEARCH_HPP
+#define MORE_THUENTE_LINE_SEARCH_HPP
+
+#include "./line_search.hpp"
+
+/** @brief
+ * Moré-Thuente line search for the strong Wolfe conditions (the dcsrch / dcstep pair of
+ * MINPACK-2). It keeps an interval of uncertainty [stx, sty] and picks every new trial from
+ * cubic and quadratic interpolation of phi and phi' at its ends, safeguarded so the interval
+ * shrinks geometrically; until the interval brackets a minimizer the step is extrapolated.
+ * Starting from a well scaled step (1 for quasi-Newton directions) it usually accepts after
+ * 1-3 evaluations. Every trial evaluates phi and phi'.
+ */
+class MoreThuenteLineSearch : public LineSearch {
+    public:
+        /** @brief c1: sufficient decrease, c2: curvature, xtol: relative width at which the interval is given up */
+        MoreThuenteLineSearch(double c1 = 1e-4, double c2 = 0.9, double xtol = 1e-10, size_t maxEvaluations = 20,
+                              double minStep = 0.0, double maxStep = 1e10);
+
+        Result search(LineRestriction& line, double value, double slope, double initialStep = 1.0) const override;
+
+    private:
+        double m_c1;
+        double m_c2;
+        double m_xtol;
+        size_t m_maxEvaluations;
+        double m_minStep;
+        double m_maxStep;
+};
+
+#endif
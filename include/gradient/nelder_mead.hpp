@@ -0,0 +1,77 @@
+#ifndef NELDER_MEAD_HPP
+#define NELDER_MEAD_HPP
+
+#include "../numerical/program.hpp"
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/thread_pool.hpp"
+#include "../Eigen/Dense"
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+
+/** @brief
+ * Nelder-Mead simplex search, for objectives that cannot (exp, log, sqrt have no rule in
+ * differentiate) or should not be differentiated: only the objective is compiled.
+ * The evaluations of an iteration go through the thread pool together: the n+1 starting
+ * vertices, the n new vertices of a shrink, and, when the pool has more than one worker, the
+ * reflection, expansion and both contraction points at once (speculatively, the iteration then
+ * keeps the one the usual rules select). With a single worker the trial points are evaluated
+ * one at a time, only as the rules need them.
+ * The adaptive variant scales the coefficients with the dimension (Gao & Han), which keeps the
+ * method from stalling in higher dimensions.
+ */
+class NelderMead {
+    public:
+        struct Parameters {
+            double reflection;  // alpha
+            double expansion;   // beta
+            double contraction; // gamma
+            double shrink;      // delta
+            /** @brief 1, 2, 1/2, 1/2 */
+            static Parameters standard();
+            /** @brief 1, 1 + 2/n, 3/4 - 1/(2n), 1 - 1/n */
+            static Parameters adaptive(size_t dimension);
+        };
+
+        /** @brief The variables are the keys of x0, which must not be empty; maxIterations 0 means 200 per variable */
+        NelderMead(
+            Node* function,
+            std::map<std::string, double> x0,
+            ThreadPool& pool,
+            bool adaptive = false,
+            double tolerance = 1e-8,
+            size_t maxIterations = 0
+        );
+        ~NelderMead();
+        /** @brief Iterate until the values and the vertices of the simplex agree within tolerance */
+        virtual void _run();
+
+        /** @brief Best vertex, in the order of the variables */
+        const Eigen::VectorXd& solution() const;
+        double value() const;
+        size_t iterations() const;
+        size_t evaluations() const;
+        size_t shrinks() const;
+
+    private:
+        Program m_program;
+        std::vector<std::string> m_variables;
+        ThreadPool& m_pool;
+        bool m_adaptive;
+        Parameters m_parameters;
+        double m_tolerance;
+        size_t m_maxIterations;
+        Eigen::VectorXd m_x;
+        double m_value;
+        size_t m_iterations;
+        size_t m_evaluations;
+        size_t m_shrinks;
+        std::vector<std::vector<double>> m_scratch; // per worker
+
+        /** @brief values[k] = f(points[k]) for all k concurrently; NaN counts as +infinity */
+        void evaluate(const std::vector<const double*>& points, double* values);
+        double evaluate(const Eigen::VectorXd& point);
+};
+
+#endif
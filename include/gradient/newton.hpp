@@ -2,29 +2,73 @@
 #define NEWTON_HPP
 
 #include "../syntax_tree/differentiator.hpp"
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/lazy_hessian.hpp"
+#include "../numerical/evaluation_context.hpp"
+#include "../numerical/line_restriction.hpp"
+#include "./line_search.hpp"
+#include "./newton_step.hpp"
 #include "../Eigen/Dense"
 #include <string>
+#include <vector>
 #include <iostream>
 #include <cmath>
+#include <optional>
 
 /** @brief
-This class is only a test for the moment, where I want to see if 
-by using Eigen I can store the jacobian and the hessian of a multivariate function
+ * Damped Newton. Every iteration factorizes the Hessian (LDLT, never an inverse); when it is
+ * not safely positive definite a multiple of the identity is added until the Cholesky
+ * factorization of H + tau*I succeeds (modified Cholesky, NewtonStep::shift), so the step is
+ * always a descent direction; a Hessian that is not finite stops the iteration. A backtracking
+ * line search on the Armijo condition globalizes the step; near the minimum the full step is
+ * accepted and convergence is quadratic.
+ * f and the gradient at an iterate come from one EvaluationContext, so their common
+ * subexpressions are evaluated once; so does the Hessian when the problem was prepared with
+ * it. Otherwise (as main.cpp prepares it) the Hessian comes from a LazyHessian: derived on the
+ * first iteration and compiled into one program of its own, which shares subexpressions among
+ * the entries but not with f and the gradient.
  */
 class Newton : public Differentiator {
     public:
         // Constructor
         Newton(
-            Node* function,
-            std::map<std::string, double> x0
+            const PreparedProblem& problem,
+            std::map<std::string, double> x0,
+            double tolerance = 1e-8,
+            size_t maxIterations = 100
         );
         // Destructor
         ~Newton();
+        /** @brief Iterate until ||g|| <= tolerance or the step is below tolerance*(1 + ||x||) */
         virtual void _run();
+
+        /** @brief Replace the default Armijo backtracking; lineSearch must outlive the solver */
+        void setLineSearch(const LineSearch& lineSearch);
+
+        /** @brief Last iterate, in the order of the problem's variables */
+        const Eigen::VectorXd& solution() const;
+        size_t iterations() const;
+        /** @brief Wall time of the factorizations, one entry per iteration */
+        const std::vector<double>& factorizationSeconds() const;
+        /** @brief Shift tau added to the diagonal, one entry per iteration (0: plain LDLT) */
+        const std::vector<double>& shifts() const;
+
     private:
-        Node* m_function;
-        std::map<std::string, double> m_x0;
-        Differentiator diff;
+        const PreparedProblem& m_problem;
+        LazyHessian m_lazyHessian; // used when the problem was prepared without its Hessian
+        EvaluationContext m_context;
+        LineRestriction m_line;
+        BacktrackingLineSearch m_defaultLineSearch;
+        const LineSearch* m_lineSearch;
+        double m_tolerance;
+        size_t m_maxIterations;
+        Eigen::VectorXd m_x; // in the order of the problem's variables
+        size_t m_iterations;
+        std::vector<double> m_factorizationSeconds;
+        std::vector<double> m_shifts;
+
+        /** @brief Newton direction -(H + tau*I)^{-1} g into d, returns tau (std::nullopt: no usable factorization) */
+        std::optional<double> direction(const Eigen::MatrixXd& hessian, const Eigen::VectorXd& gradient, Eigen::VectorXd& d) const;
 }; // class Newton
 
 #endif // Newton.hpp
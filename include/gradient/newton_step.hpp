@@ -0,0 +1,32 @@
+#ifndef NEWTON_STEP_HPP
+#define NEWTON_STEP_HPP
+
+#include "../Eigen/Dense"
+#include <functional>
+#include <iostream>
+#include <optional>
+
+/** @brief
+ * What Newton and SparseNewton share around their factorizations.
+ * shift() is the modified Cholesky policy: the Hessian as it is first, then H + tau*I with tau
+ * doubling from 1e-3 * max(1, max|H_ij|) (shifted past a non-positive diagonal), for at most
+ * MAX_SHIFTS attempts. A Hessian with NaN or infinite entries, e.g. from log or a division
+ * outside their domain, is rejected before any attempt instead of growing tau forever.
+ */
+class NewtonStep {
+    public:
+        /** @brief factorize(tau) factorizes H + tau*I and returns whether the result is usable; the tau
+         *  that was accepted, std::nullopt if the Hessian is not finite or no shift worked */
+        static std::optional<double> shift(const double* values, size_t count, double minDiagonal,
+                                           const std::function<bool(double tau)>& factorize);
+        /** @brief D of an LDL^T factorization is safely positive, relative to its largest entry */
+        static bool positive(const Eigen::VectorXd& D);
+        /** @brief The per-iteration trace line */
+        static void report(size_t iteration, double gradientNorm, double step, double tau, double seconds);
+        /** @brief The trace line of an iteration whose Hessian could not be factorized */
+        static void reportFailure(size_t iteration, double gradientNorm);
+
+        static const int MAX_SHIFTS = 64;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SPARSE_NEWTON_HPP
+#define SPARSE_NEWTON_HPP
+
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/element_hessian.hpp"
+#include "../numerical/line_restriction.hpp"
+#include "./line_search.hpp"
+#include "./newton_step.hpp"
+#include "../Eigen/Sparse"
+#include "../Eigen/SparseCholesky"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include <iostream>
+
+/** @brief
+ * Damped Newton for objectives with a sparse Hessian.
+ * The Hessian is assembled element by element (ElementHessian, lower triangle) into one sparse
+ * matrix whose pattern never changes, so the fill-reducing (AMD) ordering and the symbolic
+ * analysis of SimplicialLDLT run once, when the solver starts; every iteration only repeats
+ * the numeric factorization. An indefinite Hessian gets a diagonal shift (setShift, still no
+ * new analysis) chosen by the same NewtonStep::shift policy as Newton, and a backtracking
+ * Armijo search globalizes the step.
+ */
+class SparseNewton {
+    public:
+        SparseNewton(
+            const PreparedProblem& problem,
+            std::map<std::string, double> x0,
+            double tolerance = 1e-8,
+            size_t maxIterations = 100
+        );
+        ~SparseNewton();
+        /** @brief Iterate until ||g|| <= tolerance or the step is below tolerance*(1 + ||x||) */
+        virtual void _run();
+
+        /** @brief Replace the default Armijo backtracking; lineSearch must outlive the solver */
+        void setLineSearch(const LineSearch& lineSearch);
+
+        /** @brief Last iterate, in the order of the problem's variables */
+        const Eigen::VectorXd& solution() const;
+        size_t iterations() const;
+        /** @brief Wall time of the one symbolic analysis */
+        double analysisSeconds() const;
+        /** @brief Wall time of the numeric factorizations, one entry per iteration */
+        const std::vector<double>& factorizationSeconds() const;
+        /** @brief Nonzeros of the Hessian's lower triangle and of the factor L */
+        size_t hessianNonZeros() const;
+        size_t factorNonZeros() const;
+
+    private:
+        const PreparedProblem& m_problem;
+        ElementHessian m_elementHessian;
+        LineRestriction m_line;
+        BacktrackingLineSearch m_defaultLineSearch;
+        const LineSearch* m_lineSearch;
+        double m_tolerance;
+        size_t m_maxIterations;
+        Eigen::VectorXd m_x;
+        Eigen::SparseMatrix<double> m_hessian;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower> m_solver;
+        size_t m_iterations;
+        double m_analysisSeconds;
+        std::vector<double> m_factorizationSeconds;
+
+        /** @brief Factorize H + tau*I with the first tau of NewtonStep::shift that leaves D safely positive */
+        std::optional<double> factorize();
+};
+
+#endif
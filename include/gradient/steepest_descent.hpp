@@ -2,6 +2,10 @@
 #define STEEPEST_DESCENT_HPP
 
 #include "../syntax_tree/differentiator.hpp"
+#include "../numerical/prepared_problem.hpp"
+#include "../numerical/line_restriction.hpp"
+#include "./line_search.hpp"
+#include "./exact_line_search.hpp"
 #include "../tokenize/token.hpp"
 #include "../Eigen/Dense"
 #include <string>
@@ -17,28 +21,34 @@ class Steepest_Descent : public Differentiator
     public:
         // Constructor
         Steepest_Descent(
-            Node* function,
-            std::string expression,
+            const PreparedProblem& problem,
             double tolerance,
             double a,
             double b,
-            std::map<std::string, double> x0
+            std::map<std::string, double> x0,
+            size_t maxIterations = 10000
         );
         // Destructor
         ~Steepest_Descent();
-        // run method
+        /** @brief Iterate until ||g|| <= tolerance, the step stalls or maxIterations */
         virtual void _run();
+        /** @brief Use lineSearch instead of the exact step or Brent's method; it must outlive the solver */
+        void setLineSearch(const LineSearch& lineSearch);
     
     private:
-        Node* m_function;
-        std::string m_expression;
+        const PreparedProblem& m_problem;
+        LineRestriction m_line;
+        const LineSearch* m_lineSearch; // nullptr: m_exact for polynomials, Brent otherwise
+        ExactLineSearch m_exact;
         double m_tolerance;
+        size_t m_maxIterations;
         double d;
         double a;
         double b;
         double step;
-        std::map<std::string, double> x_new; // x_new
-        std::map<std::string, double> x_curr; // current x
+        Eigen::VectorXd x_new; // x_new, in the order of the problem's variables
+        Eigen::VectorXd x_curr; // current x
+        Eigen::VectorXd gradient;
         Differentiator differentiator;
         Token tokenizer;
 };
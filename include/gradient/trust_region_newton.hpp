@@ -0,0 +1,52 @@
+#ifndef TRUST_REGION_NEWTON_HPP
+#define TRUST_REGION_NEWTON_HPP
+
+#include "../numerical/prepared_problem.hpp"
+#include "../Eigen/Dense"
+#include <map>
+#include <string>
+#include <iostream>
+
+/** @brief
+ * Trust-region Newton with the Steihaug-Toint truncated conjugate gradient.
+ * The quadratic model m(p) = g.p + p.Hp/2 is minimized inside ||p|| <= radius by CG, which
+ * stops at the boundary, on negative curvature or once the residual is small enough. H only
+ * appears through Hessian-vector products (PreparedProblem::hessianVector), so neither the
+ * Hessian nor a factorization is ever formed: memory stays linear in n and indefinite or
+ * singular Hessians are handled. The radius follows the ratio of actual to predicted reduction.
+ */
+class TrustRegionNewton {
+    public:
+        TrustRegionNewton(
+            const PreparedProblem& problem,
+            std::map<std::string, double> x0,
+            double tolerance = 1e-6,
+            size_t maxIterations = 500,
+            double radius = 1.0,
+            double maxRadius = 1e3
+        );
+        ~TrustRegionNewton();
+        /** @brief Iterate until ||g|| <= tolerance, the radius collapses or maxIterations */
+        virtual void _run();
+
+        /** @brief Last iterate, in the order of the problem's variables */
+        const Eigen::VectorXd& solution() const;
+        size_t iterations() const;
+        size_t hessianVectorProducts() const;
+        double radius() const;
+
+    private:
+        const PreparedProblem& m_problem;
+        double m_tolerance;
+        size_t m_maxIterations;
+        double m_radius;
+        double m_maxRadius;
+        Eigen::VectorXd m_x;
+        size_t m_iterations;
+        size_t m_products;
+
+        /** @brief Steihaug CG on the model at m_x: step p and its Hp, true when p reached the boundary */
+        bool steihaug(const Eigen::VectorXd& gradient, Eigen::VectorXd& p, Eigen::VectorXd& Hp);
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef WOLFE_LINE_SEARCH_HPP
+#define WOLFE_LINE_SEARCH_HPP
+
+#include "./line_search.hpp"
+
+/** @brief
+ * Line search for the strong Wolfe conditions on phi(s) = f(x + s*d):
+ * sufficient decrease phi(s) <= phi(0) + c1*s*phi'(0) and curvature |phi'(s)| <= c2*|phi'(0)|.
+ * The step grows until it brackets an acceptable one, the bracket is then shrunk with
+ * safeguarded cubic interpolation (Nocedal & Wright, algorithms 3.5 and 3.6).
+ * Every trial evaluates phi and phi', so after search() the line's gradient() is the
+ * gradient at the returned step.
+ */
+class WolfeLineSearch : public LineSearch {
+    public:
+        WolfeLineSearch(double c1 = 1e-4, double c2 = 0.9, size_t maxEvaluations = 20);
+
+        /** @brief value and slope are phi(0) and phi'(0) < 0 */
+        Result search(LineRestriction& line, double value, double slope, double initialStep = 1.0) const override;
+
+    private:
+        double m_c1;
+        double m_c2;
+        size_t m_maxEvaluations;
+
+        struct Trial { double step, value, slope; };
+        Trial evaluate(LineRestriction& line, double step) const;
+        Result zoom(LineRestriction& line, Trial low, Trial high, double value, double slope, size_t evaluations) const;
+};
+
+#endif
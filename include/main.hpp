@@ -1,6 +1,13 @@
 #include "tokenize/token.hpp"
 #include "syntax_tree/ast.hpp"
 #include "syntax_tree/differentiator.hpp"
+#include "syntax_tree/separability.hpp"
+#include "numerical/decomposed_solver.hpp"
 #include "gradient/newton.hpp"
 #include "gradient/steepest_descent.hpp"
-#include "gradient/conjugate_gradient.hpp"
\ No newline at end of file
+#include "gradient/conjugate_gradient.hpp"
+#include "gradient/lbfgs.hpp"
+#include "gradient/bfgs.hpp"
+#include "gradient/trust_region_newton.hpp"
+#include "gradient/sparse_newton.hpp"
+#include "gradient/nelder_mead.hpp"
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef DECOMPOSED_SOLVER_HPP
+#define DECOMPOSED_SOLVER_HPP
+
+#include "./prepared_problem.hpp"
+#include "./thread_pool.hpp"
+#include "../syntax_tree/separability.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+/** @brief
+ * Minimizes a separable objective one independent subproblem at a time, concurrently.
+ * The objective is decomposed with Separability and every component is prepared as its own
+ * PreparedProblem (serially, differentiation is not thread safe). solve() then runs the given
+ * routine on every component as a ThreadPool task, each with its own problem, solver and the
+ * part of the starting point over its variables, and merges the minimizers into one point.
+ * A routine may evaluate on the same pool (e.g. NelderMead): its nested run() calls execute
+ * inline on the worker that runs the component.
+ */
+class DecomposedSolver {
+    public:
+        using Point = std::map<std::string, double>;
+        /** @brief Minimize one component from x0 (its variables only) and return the minimizer */
+        using Solve = std::function<Point(const PreparedProblem& problem, const Point& x0)>;
+
+        DecomposedSolver(Node* function, ThreadPool& pool, bool withHessian = false);
+
+        /** @brief x0 needs every variable of the objective */
+        Point solve(const Point& x0, const Solve& routine);
+        const Separability::Decomposition& decomposition() const;
+        size_t components() const;
+        /** @brief Wall time of the last solve(), per component, to spot the slow blocks */
+        const std::vector<double>& componentSeconds() const;
+
+    private:
+        ThreadPool& m_pool;
+        Separability::Decomposition m_decomposition;
+        std::vector<std::unique_ptr<PreparedProblem>> m_problems;
+        std::vector<double> m_componentSeconds;
+};
+
+#endif
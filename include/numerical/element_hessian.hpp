@@ -0,0 +1,45 @@
+#ifndef ELEMENT_HESSIAN_HPP
+#define ELEMENT_HESSIAN_HPP
+
+#include "./program.hpp"
+#include "../Eigen/Sparse"
+#include <vector>
+#include <string>
+
+/** @brief
+ * Sparse Hessian of a partially separable objective f = sum_k f_k(x_{S_k}), assembled element
+ * by element. Every term f_k only gets the small dense Hessian over its own variables S_k
+ * (upper triangle, |S_k|(|S_k|+1)/2 entries), all of them compiled into one program. The
+ * pattern of the global Hessian (the union of the S_k x S_k blocks) is built once, together
+ * with the position of every element entry in its value array, so assemble() only evaluates
+ * and scatters: O(sum |S_k|^2) work and memory instead of O(n^2).
+ */
+class ElementHessian {
+    public:
+        /** @brief FULL stores both triangles, LOWER only what SimplicialLDLT / LLT read */
+        enum Storage { FULL, LOWER };
+
+        ElementHessian(Node* function, const std::vector<std::string>& variables, Storage storage = FULL);
+
+        /** @brief Hessian at x into hessian; it takes the pattern first if it does not have it yet */
+        void assemble(const double* x, Eigen::SparseMatrix<double>& hessian) const;
+        const Eigen::SparseMatrix<double>& pattern() const;
+
+        size_t elements() const;
+        /** @brief Element entries evaluated per assembly, sum |S_k|(|S_k|+1)/2 */
+        size_t elementEntries() const;
+        size_t nonZeros() const;
+
+    private:
+        Storage m_storage;
+        Eigen::SparseMatrix<double> m_pattern;
+        Program m_program;                 // every element entry, element after element
+        std::vector<int> m_targetStart;    // per element entry, range into m_targets
+        std::vector<int> m_targets;        // positions in the value array
+        std::vector<double> m_signs;       // -1 for the entries of subtracted terms
+        size_t m_elements;
+        mutable std::vector<double> m_values;
+        mutable std::vector<double> m_results;
+};
+
+#endif
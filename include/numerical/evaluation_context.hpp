@@ -0,0 +1,62 @@
+#ifndef EVALUATION_CONTEXT_HPP
+#define EVALUATION_CONTEXT_HPP
+
+#include "./prepared_problem.hpp"
+#include <vector>
+
+/** @brief
+ * Objective, gradient and Hessian of a PreparedProblem evaluated at one point with shared work.
+ * All three are compiled into one program, so a sin, exp or power that appears in f and in
+ * its derivatives is a single slot. The epoch moves on whenever the point changes; within an
+ * epoch the context knows which parts are already computed, and value(), gradient() and
+ * hessian() only run the slots their outputs need that no computed part has produced yet.
+ * Those slot lists are planned once per (part, parts already computed) combination, so the
+ * evaluation loop itself carries no bookkeeping.
+ * Asking for f, then grad f, then the Hessian at the same x therefore never repeats a
+ * subexpression, and asking for any of them twice is free.
+ */
+class EvaluationContext {
+    public:
+        /** @brief The Hessian is available if the problem was prepared with it */
+        explicit EvaluationContext(const PreparedProblem& problem);
+
+        /** @brief Move to x; the cached values stay valid if x is the current point */
+        void setPoint(const double* x);
+        /** @brief Forget every cached value */
+        void invalidate();
+
+        double value();
+        void gradient(double* g);
+        /** @brief Row major, n*n values */
+        void hessian(double* h);
+
+        double value(const double* x);
+        void gradient(const double* x, double* g);
+        void hessian(const double* x, double* h);
+
+        size_t epoch() const;
+
+        struct Statistics {
+            size_t computed = 0; // slots evaluated
+            size_t reused = 0;   // slots that were already valid for the point
+        };
+        const Statistics& statistics() const;
+
+    private:
+        Program m_program;                     // outputs: f, grad f, Hessian (row major)
+        std::vector<std::vector<int>> m_needs; // per part, the slots it depends on, in order
+        std::vector<std::vector<std::vector<int>>> m_plans; // [part][computed parts mask], built on first use
+        std::vector<std::vector<char>> m_planned;
+        std::vector<double> m_values;
+        std::vector<double> m_x;
+        size_t m_epoch;
+        unsigned int m_computed;               // mask of the parts valid for the current epoch
+        bool m_hasPoint;
+        Statistics m_statistics;
+
+        enum Part { VALUE, GRADIENT, HESSIAN };
+        void compute(Part part);
+        const std::vector<int>& plan(Part part);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef HESSIAN_ASSEMBLER_HPP
+#define HESSIAN_ASSEMBLER_HPP
+
+#include "./lazy_hessian.hpp"
+#include "./thread_pool.hpp"
+#include "../Eigen/Dense"
+#include <vector>
+
+/** @brief
+ * Dense Hessian assembly for Newton steps on wide problems.
+ * Only the upper triangle is derived, the entries (i, j >= i) of consecutive rows are compiled
+ * together into row blocks of about the same number of entries, a few blocks per worker, so the
+ * subexpressions shared by neighbouring rows are still computed once.
+ * assemble() runs the blocks on a ThreadPool, every worker evaluating into its own scratch
+ * space, and writes straight into the caller's matrix. Row i of the upper triangle is column i
+ * of the lower one, so in Eigen's column major storage a block fills contiguous columns;
+ * with FULL storage it also mirrors them into the rows.
+ */
+class HessianAssembler {
+    public:
+        enum Storage { FULL, LOWER };
+
+        struct Timing {
+            double preparationSeconds = 0.0; // deriving and compiling, once
+            double assemblySeconds = 0.0;    // last assemble()
+            size_t entries = 0;              // evaluated entries per assembly, n(n+1)/2
+            size_t workers = 0;
+        };
+
+        HessianAssembler(const PreparedProblem& problem, ThreadPool& pool);
+
+        /** @brief Hessian at x into hessian (resized to n x n if needed).
+         *  LOWER only writes the lower triangle, which is all LLT / LDLT read. */
+        void assemble(const double* x, Eigen::MatrixXd& hessian, Storage storage = FULL);
+        const Timing& timing() const;
+
+    private:
+        const PreparedProblem& m_problem;
+        ThreadPool& m_pool;
+        struct RowBlock {
+            size_t first;    // rows first..last-1, entries (i, i..n-1) one row after the other
+            size_t last;
+            Program program;
+        };
+
+        std::vector<RowBlock> m_blocks;
+        std::vector<std::vector<double>> m_values;    // per worker
+        std::vector<std::vector<double>> m_results;   // per worker
+        Timing m_timing;
+
+        static const size_t BLOCKS_PER_WORKER = 4;
+};
+
+#endif
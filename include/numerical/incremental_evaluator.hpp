@@ -0,0 +1,60 @@
+#ifndef INCREMENTAL_EVALUATOR_HPP
+#define INCREMENTAL_EVALUATOR_HPP
+
+#include "./program.hpp"
+#include <vector>
+
+/** @brief
+ * Re-evaluates a Program after a few variables changed, for coordinate-wise and block methods.
+ * Every slot value of the previous evaluation is kept, and every variable knows the slots
+ * that depend on it (in program order). Changing a variable marks it dirty and the next
+ * evaluate() only recomputes the slots on its paths to the outputs.
+ * The top-level + / - chain of each output is treated as one n-ary sum that is updated with
+ * the change of the terms that were recomputed, so touching one variable of a separable
+ * objective costs O(terms touching that variable) instead of O(|f|). A sum whose update would
+ * not be exact (a term becoming or leaving +-inf or NaN, or cancelling most of the sum) is added
+ * up again from its terms.
+ */
+class IncrementalEvaluator {
+    public:
+        explicit IncrementalEvaluator(const Program& program);
+
+        /** @brief Full evaluation at x, which becomes the current point */
+        void bind(const double* x);
+        /** @brief Change one variable of the current point */
+        void set(size_t variable, double value);
+        /** @brief Recompute what depends on the changed variables and return the first output */
+        double evaluate();
+        double output(size_t k) const;
+        const std::vector<double>& point() const;
+        /** @brief Number of slots the last evaluate() recomputed */
+        size_t recomputed() const;
+
+        /** @brief Incremental sum updates before the sums are added up again from scratch */
+        static const size_t REFRESH_INTERVAL = 256;
+        /** @brief A sum is also added up again at once when a term changes by more than this many
+         *  times the new sum (the update cancelled digits away), or to or from a value that is not finite */
+        static constexpr double CANCELLATION = 1e4;
+
+    private:
+        const Program& m_program;
+        std::vector<double> m_x;
+        std::vector<double> m_values;
+        std::vector<double> m_outputs;
+        std::vector<std::vector<int>> m_dependents;            // per variable, slots to recompute in order
+        std::vector<std::vector<std::pair<int, double>>> m_terms; // per output, (slot, sign) of its top-level sum
+        std::vector<int> m_termStart;                            // per slot, range into m_termOwners
+        std::vector<std::pair<int, double>> m_termOwners;        // (output, sign) of every sum a slot is a term of
+        std::vector<char> m_dirtyVariable;
+        std::vector<size_t> m_dirty;
+        std::vector<int> m_merged;
+        std::vector<char> m_staleOutput;
+        std::vector<size_t> m_stale;                             // outputs to add up again after this evaluate()
+        size_t m_recomputed;
+        size_t m_updatesSinceRefresh;
+
+        void sumOutputs();
+        void sumOutput(size_t k);
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef LAZY_HESSIAN_HPP
+#define LAZY_HESSIAN_HPP
+
+#include "./prepared_problem.hpp"
+#include "../Eigen/Dense"
+#include <map>
+#include <vector>
+
+/** @brief
+ * Hessian of a PreparedProblem whose entries are derived and compiled on demand.
+ * An entry is differentiated the first time any access needs it, only for i <= j (the
+ * Hessian is symmetric, (j, i) reads (i, j)), and kept for every later access.
+ * Entries, rows, the diagonal and square blocks are each compiled into one program the first
+ * time they are asked for, so a solver that only needs the diagonal (preconditioning) or a few
+ * blocks never pays for the n^2 second derivatives.
+ * Like PreparedProblem, it must not be used from several threads at once.
+ */
+class LazyHessian {
+    public:
+        /** @brief problem does not need to be prepared with its Hessian */
+        explicit LazyHessian(const PreparedProblem& problem);
+
+        double entry(const double* x, size_t i, size_t j);
+        /** @brief Row i into row (n values) */
+        void row(const double* x, size_t i, double* row);
+        /** @brief Diagonal into diagonal (n values) */
+        void diagonal(const double* x, double* diagonal);
+        /** @brief The square block on indices (rows and columns), row major into block */
+        void block(const double* x, const std::vector<size_t>& indices, double* block);
+        /** @brief One dense block per index set, the rest of the Hessian is never derived */
+        std::vector<Eigen::MatrixXd> blockDiagonal(const double* x, const std::vector<std::vector<size_t>>& blocks);
+        /** @brief The whole n x n Hessian, through the block of all indices */
+        Eigen::MatrixXd full(const double* x);
+
+        /** @brief Symbolic entry (i, j), derived on first use */
+        Node* entryNode(size_t i, size_t j);
+        /** @brief Second derivatives derived so far (upper triangle only) */
+        size_t derivedEntries() const;
+        size_t compiledPrograms() const;
+
+    private:
+        const PreparedProblem& m_problem;
+        Differentiator m_differentiator;
+        std::map<std::pair<size_t, size_t>, Node*> m_entries;
+        std::map<std::pair<size_t, size_t>, Program> m_entryPrograms;
+        std::map<size_t, Program> m_rowPrograms;
+        std::map<std::vector<size_t>, Program> m_blockPrograms; // upper triangle of the block, row by row
+        Program m_diagonalProgram;
+        bool m_hasDiagonal;
+        std::vector<double> m_values;
+        std::vector<double> m_results;
+
+        void check(size_t i) const;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef LINE_RESTRICTION_HPP
+#define LINE_RESTRICTION_HPP
+
+#include "./prepared_problem.hpp"
+#include <vector>
+
+/** @brief
+ * The objective restricted to a line, phi(s) = f(x + s*d), for line searches.
+ * It runs the compiled programs of a PreparedProblem directly, there is no text involved.
+ * setLine() evaluates once every slot that does not depend on s (constants, and everything
+ * built only from variables whose direction component is 0), so a trial step only recomputes
+ * the slots that actually move along the line.
+ */
+class LineRestriction {
+    public:
+        explicit LineRestriction(const PreparedProblem& problem);
+
+        /** @brief Restrict to the line through x along d (both in the order of the problem variables) */
+        void setLine(const double* x, const double* d);
+        /** @brief phi(s) */
+        double value(double s);
+        /** @brief phi'(s) = grad f(x + s*d) . d */
+        double derivative(double s);
+        /** @brief grad f at the point of the last derivative() call into g, at no extra cost */
+        void gradient(double* g) const;
+        /** @brief x + s*d into point */
+        void point(double s, double* point) const;
+        /** @brief Number of phi and phi' evaluations since the last setLine() */
+        size_t evaluations() const;
+
+    private:
+        // One program restricted to the line: the slots that move with s and the values of the others
+        struct Restricted {
+            const Program* program;
+            std::vector<double> values;
+            std::vector<int> moving;
+
+            void setLine(const double* x, const double* d);
+            void run(double s, const double* x, const double* d);
+        };
+
+        const PreparedProblem& m_problem;
+        std::vector<double> m_x;
+        std::vector<double> m_d;
+        Restricted m_objective;
+        Restricted m_gradient;
+        size_t m_evaluations;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef PARALLEL_EVALUATOR_HPP
+#define PARALLEL_EVALUATOR_HPP
+
+#include "./program.hpp"
+#include "./thread_pool.hpp"
+#include <vector>
+#include <string>
+
+/** @brief
+ * Evaluates one big objective, its gradient and Hessian-vector products on a ThreadPool.
+ * The summands of the top-level + / - are grouped into chunks of roughly equal node count,
+ * every chunk is compiled (and differentiated) on its own, the chunks run as independent
+ * tasks and their partial sums are added up in chunk order, so results do not depend on
+ * the scheduling. Chunks are small enough for a few tasks per worker, to leave something
+ * to steal, but never below MIN_CHUNK_NODES, where the scheduling would cost more than it saves.
+ * Each worker has its own scratch space; one evaluator must still be used by one caller at a time.
+ */
+class ParallelEvaluator {
+    public:
+        ParallelEvaluator(Node* function, const std::vector<std::string>& variables, ThreadPool& pool, bool withDerivatives = true);
+
+        double value(const double* x);
+        /** @brief Gradient into g (n values) */
+        void gradient(const double* x, double* g);
+        /** @brief Hessian times v into hv, forward mode through the chunk gradients */
+        void hessianVector(const double* x, const double* v, double* hv);
+
+        size_t chunks() const;
+        /** @brief Cost model: number of distinct nodes of the DAG under root */
+        static size_t nodeCount(Node* root);
+
+        static const size_t MIN_CHUNK_NODES = 2048;
+        static const size_t TASKS_PER_WORKER = 4;
+
+    private:
+        struct Chunk {
+            Program objective;
+            Program gradient;              // partials w.r.t. the chunk variables only
+            std::vector<size_t> variables; // indices of the variables the chunk depends on
+        };
+
+        std::vector<std::string> m_variables;
+        ThreadPool& m_pool;
+        bool m_withDerivatives;
+        std::vector<Chunk> m_chunks;
+        std::vector<double> m_partialValues;
+        std::vector<std::vector<double>> m_partialVectors;
+        std::vector<std::vector<double>> m_values;   // per worker
+        std::vector<std::vector<double>> m_tangents; // per worker
+
+        void mergeVectors(double* result) const;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef PREPARED_PROBLEM_HPP
+#define PREPARED_PROBLEM_HPP
+
+#include "./program.hpp"
+#include "../syntax_tree/differentiator.hpp"
+#include "../Eigen/Dense"
+#include <map>
+#include <vector>
+#include <string>
+
+/** @brief
+ * An objective prepared for optimization: the objective, its gradient and (optionally) its
+ * Hessian are differentiated, simplified and compiled once, when the problem is created.
+ * A solver iteration then only binds a new point and evaluates the programs.
+ * Evaluation reuses one scratch buffer, so a PreparedProblem must not be evaluated from
+ * several threads at once.
+ */
+class PreparedProblem {
+    public:
+        PreparedProblem(Node* function, const std::vector<std::string>& variables, bool withHessian = false);
+        /** @brief The variables are the keys of the starting point */
+        PreparedProblem(Node* function, const std::map<std::string, double>& x0, bool withHessian = false);
+
+        /** @brief Objective value, x is in the order of variables() */
+        double value(const double* x) const;
+        /** @brief Gradient into g (n values) */
+        void gradient(const double* x, double* g) const;
+        /** @brief Hessian into h (n*n values, row major) */
+        void hessian(const double* x, double* h) const;
+        /** @brief Hessian times v into hv, forward mode through the gradient program (no Hessian needed) */
+        void hessianVector(const double* x, const double* v, double* hv) const;
+
+        double value(const std::map<std::string, double>& point) const;
+        /** @brief 1 x n, like Differentiator::computeJacobian */
+        Eigen::MatrixXd gradient(const std::map<std::string, double>& point) const;
+        /** @brief n x n, like Differentiator::computeHessian */
+        Eigen::MatrixXd hessian(const std::map<std::string, double>& point) const;
+
+        Node* function() const;
+        const std::vector<std::string>& variables() const;
+        size_t dimension() const;
+        bool hasHessian() const;
+        /** @brief Symbolic first and second partial derivatives the programs were compiled from */
+        Node* gradientNode(size_t i) const;
+        Node* hessianNode(size_t i, size_t j) const;
+        const Program& objectiveProgram() const;
+        const Program& gradientProgram() const;
+        const Program& hessianProgram() const;
+        /** @brief Wall time spent differentiating and compiling */
+        double preparationSeconds() const;
+        /** @brief point as an array in the order of variables() */
+        std::vector<double> toVector(const std::map<std::string, double>& point) const;
+        /** @brief Solver state: the same point as a dense Eigen vector, and back */
+        Eigen::VectorXd toEigen(const std::map<std::string, double>& point) const;
+        std::map<std::string, double> toMap(const Eigen::VectorXd& x) const;
+        /** @brief Position of a variable in variables(), throws std::invalid_argument for unknown names */
+        size_t index(const std::string& variable) const;
+        /** @brief "x = 1, y = 2" for the solvers' reports */
+        std::string describe(const Eigen::VectorXd& x) const;
+        /** @brief The same, for solvers that keep their own variables instead of a PreparedProblem */
+        static std::string describe(const std::vector<std::string>& variables, const Eigen::VectorXd& x);
+
+    private:
+        Node* m_function;
+        std::vector<std::string> m_variables;
+        std::map<std::string, size_t> m_index;
+        bool m_hasHessian;
+        std::vector<Node*> m_gradientNodes;
+        std::vector<Node*> m_hessianNodes;
+        Program m_objective;
+        Program m_gradient;
+        Program m_hessian;
+        double m_preparationSeconds;
+        mutable std::vector<double> m_values; // evaluation scratch space
+        mutable std::vector<double> m_tangents;
+
+        void prepare();
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef PROGRAM_HPP
+#define PROGRAM_HPP
+
+#include "../syntax_tree/ast.hpp"
+#include <map>
+#include <vector>
+#include <string>
+#include <tuple>
+#include <cstdint>
+
+/** @brief
+ * An expression (or several of them) compiled into a flat list of instructions.
+ * Every instruction writes one slot and only reads slots written before it, so a single
+ * pass over the list evaluates everything: no strings, no std::stod, no map lookups.
+ * Identical subexpressions are emitted once (also across several roots), constants are
+ * folded, and the trees go through Lowering::lower before they are compiled.
+ */
+class Program {
+    public:
+        enum OpCode { CONSTANT, VARIABLE, ADD, SUB, MUL, DIV, POW, NEG, SQRT, SIN, COS, TAN, SEC2, LOG, EXP };
+
+        struct Instruction {
+            OpCode op;
+            int lhs;      // operand slot, or the variable index for VARIABLE
+            int rhs;      // second operand slot, -1 for unary operations
+            double value; // CONSTANT payload
+        };
+
+        Program();
+        Program(Node* root, const std::vector<std::string>& variables, bool lower = true);
+        /** @brief Compile several roots into one program sharing their common subexpressions */
+        Program(const std::vector<Node*>& roots, const std::vector<std::string>& variables, bool lower = true);
+
+        /** @brief Evaluate every slot, x is in the order of variables() */
+        void run(const double* x, double* values) const;
+        /** @brief Evaluate and return the first output, values is the caller's scratch space */
+        double evaluate(const double* x, std::vector<double>& values) const;
+        /** @brief Evaluate and write every output into results */
+        void evaluate(const double* x, std::vector<double>& values, double* results) const;
+        /** @brief Forward mode: run() plus, in tangents, the derivative of every slot along v */
+        void runTangent(const double* x, const double* v, double* values, double* tangents) const;
+        /** @brief Convenience overload, allocates its own scratch space */
+        double evaluate(const std::map<std::string, double>& point) const;
+
+        /** @brief Result of a single operation, shared by every evaluator of programs */
+        static double apply(OpCode op, double a, double b);
+        /** @brief Value of one instruction given the point and the slots before it */
+        static inline double compute(const Instruction& instruction, const double* x, const double* values) {
+            switch (instruction.op) {
+            case CONSTANT: return instruction.value;
+            case VARIABLE: return x[instruction.lhs];
+            case ADD: return values[instruction.lhs] + values[instruction.rhs];
+            case SUB: return values[instruction.lhs] - values[instruction.rhs];
+            case MUL: return values[instruction.lhs] * values[instruction.rhs];
+            case DIV: return values[instruction.lhs] / values[instruction.rhs];
+            case NEG: return -values[instruction.lhs];
+            default: return apply(instruction.op, values[instruction.lhs], instruction.rhs < 0 ? 0.0 : values[instruction.rhs]);
+            }
+        }
+
+        size_t size() const;
+        const std::vector<Instruction>& instructions() const;
+        const std::vector<int>& outputs() const;
+        const std::vector<std::string>& variables() const;
+
+    private:
+        std::vector<Instruction> m_code;
+        std::vector<int> m_outputs;
+        std::vector<std::string> m_variables;
+        std::map<std::tuple<int, int, int, uint64_t>, int> m_emitted; // common subexpression table
+
+        void compile(const std::vector<Node*>& roots, bool lower);
+        int compileNode(Node* node, std::map<Node*, int>& compiled);
+        int emit(OpCode op, int lhs, int rhs, double value = 0.0);
+};
+
+#endif
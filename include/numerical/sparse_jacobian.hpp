@@ -0,0 +1,44 @@
+#ifndef SPARSE_JACOBIAN_HPP
+#define SPARSE_JACOBIAN_HPP
+
+#include "./program.hpp"
+#include "../Eigen/Sparse"
+#include <vector>
+#include <string>
+
+/** @brief
+ * Residuals r_1..r_m of a vector-valued function and their sparse m x n Jacobian.
+ * The sparsity pattern (which residual depends on which variable) is found once, when the
+ * object is created, and only the structurally non-zero partials are derived. They are
+ * compiled into one program whose outputs are in the order of the compressed column storage,
+ * so jacobian() evaluates straight into the value array of a preallocated SparseMatrix and
+ * never touches its structure again. All residuals, and all partials, are compiled together,
+ * which shares the subexpressions they have in common.
+ */
+class SparseJacobian {
+    public:
+        SparseJacobian(const std::vector<Node*>& residuals, const std::vector<std::string>& variables);
+
+        /** @brief Residual values into r (m values) */
+        void residuals(const double* x, double* r) const;
+        /** @brief Jacobian at x into jacobian; it takes the pattern first if it does not have it yet */
+        void jacobian(const double* x, Eigen::SparseMatrix<double>& jacobian) const;
+        /** @brief The Jacobian structure, values are meaningless */
+        const Eigen::SparseMatrix<double>& pattern() const;
+
+        size_t rows() const;
+        size_t cols() const;
+        size_t nonZeros() const;
+        /** @brief Symbolic partial of residual i w.r.t. variable j, nullptr outside the pattern */
+        Node* partialNode(size_t i, size_t j) const;
+
+    private:
+        std::vector<std::string> m_variables;
+        Eigen::SparseMatrix<double> m_pattern;
+        std::vector<Node*> m_partials; // in the order of m_pattern's values
+        Program m_residuals;
+        Program m_jacobian;
+        mutable std::vector<double> m_values; // evaluation scratch space
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SPECIALIZER_HPP
+#define SPECIALIZER_HPP
+
+#include "./prepared_problem.hpp"
+#include <map>
+#include <vector>
+#include <string>
+
+/** @brief
+ * Partial evaluation of an objective on a binding of some of its variables to constants,
+ * for parameter sweeps, block coordinate descent and scenario analysis.
+ * bind() substitutes the constants, folds every subexpression that became constant and
+ * normalizes the polynomial parts, so the result only depends on the free variables.
+ * specialize() prepares that expression (objective, gradient and optionally Hessian programs
+ * over the free variables) and keeps it, so asking again for the same binding is free.
+ */
+class Specializer {
+    public:
+        /** @brief variables are all the variables of the function, in the order the free ones keep */
+        Specializer(Node* function, const std::vector<std::string>& variables, bool withHessian = false);
+
+        /** @brief Prepared problem over the variables not in binding, built the first time the binding is seen */
+        const PreparedProblem& specialize(const std::map<std::string, double>& binding);
+        /** @brief Variables left free by binding, in the order of the original variables */
+        std::vector<std::string> freeVariables(const std::map<std::string, double>& binding) const;
+
+        /** @brief Constant folded and simplified copy of function with the bound variables substituted.
+         *  The input tree is never modified. */
+        static Node* bind(Node* function, const std::map<std::string, double>& binding);
+
+        size_t cacheSize() const;
+        void clearCache();
+
+    private:
+        Node* m_function;
+        std::vector<std::string> m_variables;
+        bool m_withHessian;
+        std::map<std::map<std::string, double>, PreparedProblem> m_specialized;
+
+        static Node* bindNode(Node* node, const std::map<std::string, double>& binding, std::map<Node*, Node*>& bound);
+};
+
+#endif
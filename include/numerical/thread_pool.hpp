@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @brief
+ * Work-stealing pool for the parallel evaluators.
+ * run() hands out the tasks 0..count-1 in contiguous ranges, one deque per worker. A worker
+ * takes tasks from the back of its own deque and, once it is empty, steals from the front of
+ * the others, so uneven tasks still keep every core busy.
+ * The calling thread works as worker 0 while it waits, so a pool of size() workers owns
+ * size() - 1 threads and a pool of size 1 simply runs everything inline.
+ * A task may call run() on its own pool again (a solver on a subproblem that evaluates on the
+ * pool): the nested tasks run inline on that worker instead of waiting for the busy pool.
+ */
+class ThreadPool {
+    public:
+        /** @brief workers = 0 uses one worker per hardware thread */
+        explicit ThreadPool(size_t workers = 0);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /** @brief Run body(task, worker) for every task and wait for all of them.
+         *  worker < size() identifies the thread, for per-thread scratch space.
+         *  The first exception thrown by a task is rethrown here.
+         *  Called from inside a task of this pool, the tasks run inline with the caller's worker. */
+        void run(size_t count, const std::function<void(size_t task, size_t worker)>& body);
+        size_t size() const;
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<size_t> tasks;
+        };
+
+        std::vector<std::thread> m_threads;
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::mutex m_mutex;                 // guards everything below
+        std::mutex m_runMutex;              // one run() at a time
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const std::function<void(size_t, size_t)>* m_body;
+        size_t m_generation;
+        size_t m_remaining;
+        std::exception_ptr m_error;
+        bool m_stop;
+
+        void work(size_t worker);
+        void drain(size_t worker);
+        bool next(size_t worker, size_t& task);
+};
+
+#endif
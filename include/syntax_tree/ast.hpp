@@ -4,6 +4,7 @@
 #include <iostream>
 #include <queue>
 #include <stack>
+#include <optional>
 #include "../tokenize/token.hpp"
 
 // Node that takes a token as value
@@ -16,6 +17,15 @@ public:
 	Node(Token::TokenData value) : data(value), left(nullptr), right(nullptr) {}
 	// New constructor to handle left and right children
     Node(Token::TokenData value, Node* leftNode, Node* rightNode) : data(value), left(leftNode), right(rightNode) {}
+
+	/** @brief Value of a NUMBER node, std::nullopt for anything else */
+	static std::optional<double> numberValue(const Node* node) {
+		if (!node || node->data.type != Token::NUMBER) return std::nullopt;
+		return std::stod(node->data.value);
+	}
+	static Node* number(double value) {
+		return new Node(Token::TokenData(Token::NUMBER, Token::numberToString(value)));
+	}
 };
 
 // Binary Tree
@@ -2,7 +2,13 @@
 #define DIFFERENTIATOR_HPP
 
 #include "./ast.hpp"
+#include "./egraph.hpp"
+#include "./polynomial.hpp"
+#include "../numerical/program.hpp"
 #include "../Eigen/Dense"
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 
 class Differentiator : public AST{
     public:
@@ -19,6 +25,42 @@ class Differentiator : public AST{
         Eigen::MatrixXd computeHessian(Node* function, const std::map<std::string, double>& variablesMap);
         /** @brief Compute the norm between two vectors */
         double norm(const std::map<std::string, double>& point1, const std::map<std::string, double>& point2);
+        /** @brief Run the e-graph simplifier after simplify() on every derivative (off by default) */
+        void setEGraphSimplification(bool enabled, const EGraph::Limits& limits = EGraph::Limits(), const CostModel& model = CostModel());
+
+        struct CacheStatistics {
+            size_t hits = 0;      // partial derivatives served from the cache
+            size_t misses = 0;    // partial derivatives actually differentiated
+            size_t programs = 0;  // derivatives compiled for evaluation
+        };
+        /** @brief Simplified partial derivative, differentiated only the first time (function, var) is asked for */
+        Node* partialDerivative(Node* function, const std::string& var);
+        /** @brief Evaluate an expression with its cached evaluator (Horner for polynomials, a compiled Program otherwise) */
+        double evaluateCached(Node* expression, const std::map<std::string, double>& variablesMap);
+        const CacheStatistics& cacheStatistics() const;
+        void clearDerivativeCache();
+
+    private:
+        bool m_useEGraph;
+        EGraph::Limits m_egraphLimits;
+        CostModel m_costModel;
+        /** @brief simplify() followed by the optional e-graph pass */
+        Node* simplifyDerivative(Node* root);
+
+        // Derivative cache, keyed by the structure of an expression rather than its address: equal
+        // trees share their entries. The id of every node seen is remembered, so a repeated call
+        // is a lookup; the trees given to the cache must therefore stay alive and unchanged until
+        // clearDerivativeCache() (nodes are never freed or rewritten in place here)
+        using StructureKey = std::tuple<int, std::string, size_t, size_t>; // type, value, operand ids
+        std::map<StructureKey, size_t> m_structures;
+        std::unordered_map<const Node*, size_t> m_nodeIds;
+        std::map<std::pair<size_t, std::string>, Node*> m_partials;
+        std::map<size_t, std::optional<Polynomial>> m_polynomials;
+        std::map<size_t, Program> m_programs;
+        CacheStatistics m_cacheStatistics;
+        /** @brief Id shared by all trees that are equal node by node, 0 for nullptr; only nodes not seen before are interned */
+        size_t structureId(const Node* root);
+        const std::optional<Polynomial>& polynomialForm(Node* expression, size_t id);
 };
 
 #endif
\ No newline at end of file
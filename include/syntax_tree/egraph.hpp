@@ -0,0 +1,126 @@
+#ifndef EGRAPH_HPP
+#define EGRAPH_HPP
+
+#include "./ast.hpp"
+#include <map>
+#include <vector>
+#include <string>
+#include <optional>
+#include <functional>
+
+/** @brief
+ * Cost model used to pick the cheapest expression out of an e-graph.
+ * The weights are rough latencies in cycles on a modern x86 core, so that
+ * pow and the trigonometric functions are much more expensive than * and +.
+ */
+struct CostModel {
+    double number = 0.0;
+    double variable = 0.0;
+    double add = 4.0;      // + and -
+    double negate = 1.0;   // unary -
+    double multiply = 4.0;
+    double divide = 14.0;
+    double power = 80.0;
+    double sqrt = 18.0;
+    double sin = 60.0;
+    double cos = 60.0;
+    double tan = 80.0;
+    double sec2 = 80.0;
+    double exp = 40.0;
+    double log = 40.0;
+
+    /** @brief Cost of a single operation, not counting its operands */
+    double operationCost(const Token::TokenData& data, size_t arity) const;
+    /** @brief Cost of evaluating a whole tree once */
+    double cost(Node* root) const;
+};
+
+/** @brief Budget of an equality saturation run */
+struct SaturationLimits {
+    size_t maxIterations = 12;
+    size_t maxNodes = 10000;
+    double maxSeconds = 0.25;
+};
+
+/** @brief
+ * Equality saturation over the expressions of the AST.
+ * An e-graph stores many equivalent expressions at once: every e-class is a set of
+ * e-nodes (an operation whose operands are e-classes) that are known to be equal.
+ * Rewrite rules only ever add equalities, so they are applied until nothing new
+ * can be learned (saturation) or until the budget runs out, and the cheapest
+ * member of the root class is extracted at the end.
+ */
+class EGraph {
+    public:
+        struct ENode {
+            Token::TokenData data;
+            std::vector<int> children;
+
+            bool operator<(const ENode& other) const;
+        };
+
+        /** @brief Pattern of a rewrite rule, "?a" style names are pattern variables */
+        struct Pattern {
+            std::string variable;
+            Token::TokenData data{Token::NUMBER, ""};
+            std::vector<Pattern> children;
+        };
+
+        using Substitution = std::map<std::string, int>;
+
+        struct Rewrite {
+            std::string name;
+            Pattern lhs;
+            Pattern rhs;
+            std::function<bool(const EGraph&, const Substitution&)> condition;
+        };
+
+        using Limits = SaturationLimits;
+
+        enum StopReason { SATURATED, ITERATION_LIMIT, NODE_LIMIT, TIME_LIMIT };
+
+        struct Report {
+            size_t iterations = 0;
+            size_t nodes = 0;
+            size_t classes = 0;
+            StopReason reason = SATURATED;
+        };
+
+        EGraph();
+        /** @brief Add a tree to the e-graph and return the id of its e-class */
+        int add(Node* root);
+        /** @brief Canonical id of an e-class */
+        int find(int id) const;
+        /** @brief Apply the rules until saturation or until the limits are hit */
+        Report saturate(const std::vector<Rewrite>& rules, const Limits& limits = Limits());
+        /** @brief Build the cheapest tree of an e-class under the given cost model */
+        Node* extract(int id, const CostModel& model = CostModel()) const;
+        /** @brief Constant value of an e-class, if it is known */
+        std::optional<double> constant(int id) const;
+        size_t nodeCount() const;
+        size_t classCount() const;
+
+        /** @brief Build a rule from two s-expressions, e.g. "(* ?a (+ ?b ?c))" */
+        static Rewrite rewrite(const std::string& name, const std::string& lhs, const std::string& rhs,
+                               std::function<bool(const EGraph&, const Substitution&)> condition = nullptr);
+        /** @brief Commutativity, associativity, distributivity, power laws and trig identities */
+        static std::vector<Rewrite> defaultRules();
+        /** @brief Saturate a single tree with the default rules and extract the cheapest equivalent */
+        static Node* simplify(Node* root, const Limits& limits = Limits(), const CostModel& model = CostModel(), Report* report = nullptr);
+
+    private:
+        std::vector<int> m_parent;               // union-find
+        std::vector<std::vector<ENode>> m_nodes; // e-nodes of every canonical e-class
+        std::vector<std::optional<double>> m_constant;
+        std::map<ENode, int> m_memo;             // hashcons of canonical e-nodes
+
+        int addNode(ENode node);
+        int instantiate(const Pattern& pattern, const Substitution& substitution);
+        void match(const Pattern& pattern, int id, const Substitution& substitution, std::vector<Substitution>& matches) const;
+        bool merge(int a, int b);
+        void canonicalize(ENode& node) const;
+        std::optional<double> fold(const ENode& node) const;
+        void rebuild();
+};
+
+#endif
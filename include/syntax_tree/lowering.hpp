@@ -0,0 +1,29 @@
+#ifndef LOWERING_HPP
+#define LOWERING_HPP
+
+#include "./ast.hpp"
+#include <map>
+
+/** @brief
+ * Strength reduction that runs on a tree right before it is handed to an evaluation backend.
+ * Expensive operations are replaced with cheaper equivalent ones:
+ *  - x^n for an integer n becomes a chain of multiplications (exponentiation by squaring),
+ *  - x^0.5 becomes sqrt(x) and x^-0.5 becomes 1 / sqrt(x),
+ *  - x / c for a constant c becomes x * (1/c),
+ *  - exp(a) * exp(b) becomes exp(a + b).
+ * The input tree is never modified and shared subtrees stay shared in the result.
+ */
+class Lowering {
+    public:
+        /** @brief Return the lowered tree */
+        static Node* lower(Node* root);
+
+        /** @brief Largest |n| for which x^n is expanded into multiplications */
+        static const int MAX_EXPANDED_POWER = 32;
+
+    private:
+        static Node* lowerNode(Node* node, std::map<Node*, Node*>& lowered);
+        static Node* powerChain(Node* base, unsigned int exponent);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef POLYNOMIAL_HPP
+#define POLYNOMIAL_HPP
+
+#include "./ast.hpp"
+#include "./egraph.hpp"
+#include <map>
+#include <vector>
+#include <string>
+#include <optional>
+
+/** @brief
+ * Canonical sparse polynomial: a map from monomials (one exponent per variable)
+ * to their coefficients. Deep +, *, ^ trees collapse into this normal form, where
+ * like terms are collected, differentiation is exact and cheap, and evaluation
+ * uses a multivariate Horner scheme instead of walking the tree.
+ */
+class Polynomial {
+    public:
+        using Monomial = std::vector<int>; // exponents, in the order of variables()
+
+        Polynomial();
+        explicit Polynomial(const std::vector<std::string>& variables);
+
+        static Polynomial constant(const std::vector<std::string>& variables, double value);
+        static Polynomial variable(const std::vector<std::string>& variables, size_t index);
+
+        /** @brief Convert a tree over its own variables (sorted by name), std::nullopt if it is not a polynomial */
+        static std::optional<Polynomial> fromAST(Node* root);
+        /** @brief Convert a tree over the given variables, std::nullopt if it is not a polynomial in them */
+        static std::optional<Polynomial> fromAST(Node* root, const std::vector<std::string>& variables);
+        /** @brief Rewrite every polynomial subtree into its normal form, where that is cheaper to evaluate */
+        static Node* normalize(Node* root, const CostModel& model = CostModel());
+
+        /** @brief Convert back to a tree: a sum of coefficient * x^a * y^b terms */
+        Node* toAST() const;
+        Polynomial differentiate(const std::string& var) const;
+        Polynomial differentiate(size_t index) const;
+        /** @brief Horner evaluation, values are in the order of variables() */
+        double evaluate(const double* values) const;
+        double evaluate(const std::map<std::string, double>& point) const;
+
+        int degree() const;
+        size_t size() const;
+        bool isConstant() const;
+        const std::vector<std::string>& variables() const;
+        const std::map<Monomial, double>& terms() const;
+
+        Polynomial operator+(const Polynomial& other) const;
+        Polynomial operator-(const Polynomial& other) const;
+        Polynomial operator*(const Polynomial& other) const;
+        Polynomial operator*(double factor) const;
+        Polynomial pow(unsigned int exponent) const;
+
+        /** @brief Conversion gives up past this many terms, e.g. on (x+y+z)^40 */
+        static const size_t MAX_TERMS = 4096;
+
+    private:
+        std::vector<std::string> m_variables;
+        std::map<Monomial, double> m_terms;
+
+        void addTerm(const Monomial& monomial, double coefficient);
+        /** @brief Polynomial of one node from the ones of its operands, std::nullopt if it is not one */
+        static std::optional<Polynomial> fromNode(Node* node, const std::optional<Polynomial>& left,
+                                                  const std::optional<Polynomial>& right,
+                                                  const std::vector<std::string>& variables);
+        double horner(std::map<Monomial, double>::const_iterator first,
+                      std::map<Monomial, double>::const_iterator last,
+                      size_t variable, const double* values) const;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SEPARABILITY_HPP
+#define SEPARABILITY_HPP
+
+#include "./ast.hpp"
+#include <vector>
+#include <string>
+
+/** @brief
+ * Splits an objective into independent subproblems.
+ * The summands of the top-level + / - are the terms of the objective; two variables interact
+ * when some term contains both. The connected components of that interaction graph (found
+ * with a union-find over the variables) are subproblems that can be minimized separately:
+ * the minimum of the sum is the sum of the minima.
+ */
+class Separability {
+    public:
+        struct Component {
+            std::vector<std::string> variables; // sorted
+            Node* function;                     // sum of the terms over these variables
+            size_t terms;
+        };
+
+        struct Decomposition {
+            std::vector<Component> components; // ordered by their first variable
+            Node* constant;                    // terms without variables, nullptr if there are none
+        };
+
+        static Decomposition decompose(Node* root);
+        /** @brief Summands of the top-level + / - chain, with true for the subtracted ones */
+        static std::vector<std::pair<Node*, bool>> terms(Node* root);
+        /** @brief Sum of signed terms (as returned by terms()), added pairwise to keep the tree shallow */
+        static Node* sum(const std::vector<std::pair<Node*, bool>>& terms);
+        /** @brief Variables of a tree, without the sign of "-x" leaves, sorted */
+        static std::vector<std::string> variables(Node* root);
+};
+
+#endif
@@ -12,6 +12,7 @@
 #include <stack>  // For operations
 #include <queue>  // For queue
 #include <array> //  For tokens.
+#include <optional>
 
 /** @brief: This class is supposed to tokenize a mathematical expression 
 After tokenizing, it will be passed further to the Shunting Yard algorithm or the AST.
@@ -43,13 +44,31 @@ public:
 	};
 
 	std::string replace_all(std::string& str, const std::string& from, const std::string& to);
+	static std::string numberToString(double value);
+	/** @brief Constant folding, shared by every pass that rewrites trees: a function or unary minus
+	 * applied to a, std::nullopt for any other token */
+	static std::optional<double> fold(const TokenData& data, double a);
+	/** @brief A binary operator applied to a and b, std::nullopt for any other token */
+	static std::optional<double> fold(const TokenData& data, double a, double b);
 	std::string tokenTypeToString(TokenData tkData);
 	std::vector<Token::TokenData> tokenize(const std::string &expr);
 	std::queue<Token::TokenData> ShuntingYard(const std::vector<Token::TokenData> &tokens);
 	double evaluateRPN(std::queue<Token::TokenData> outputQueue, const std::map<std::string, double>& variableValues);
 	std::pair<double,double> golden_section(std::queue<Token::TokenData> outputQueue, double a, double b, double e, const char* variableName);
+	/** @brief Golden section search on any 1-D function, e.g. a LineRestriction */
+	std::pair<double,double> golden_section(const std::function<double(double)>& function, double a, double b, double e);
 	std::pair<double,double> fibonacci_series(std::queue<Token::TokenData> outputQueue, double a, double b, double e, const char* variableName);
 
+	struct Minimum {
+		double x;
+		double value;
+		size_t evaluations;
+	};
+	/** @brief Brent's method: a bracket is first expanded geometrically downhill from a and b, then
+	 * parabolic interpolation (golden section when it misbehaves) shrinks it to width e, with one
+	 * new evaluation per iteration */
+	Minimum brent(const std::function<double(double)>& function, double a, double b, double e, size_t maxEvaluations = 500);
+
 private:
 	int getPrecedence(const std::string &op);
 	bool isLeftAssociative(const std::string &op);
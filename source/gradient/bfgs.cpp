@@ -0,0 +1,115 @@
+#include "../../include/gradient/bfgs.hpp"
+#include <algorithm>
+#include <cmath>
+
+/** @brief Class constructor
+ * @param problem: the function prepared with its gradient (no Hessian is used),
+ * @param x0: the starting point,
+ * @param tolerance: on the gradient norm,
+ * @param maxIterations: upper bound on the iterations.
+ */
+BFGS::BFGS(
+    const PreparedProblem& problem,
+    std::map<std::string, double> x0,
+    double tolerance,
+    size_t maxIterations
+)
+: m_problem(problem)
+, m_line(problem)
+, m_lineSearch(&m_defaultLineSearch)
+, m_tolerance(tolerance)
+, m_maxIterations(maxIterations)
+, m_x(problem.toEigen(x0))
+, m_iterations(0)
+, m_evaluations(0)
+, m_resets(0)
+{}
+
+BFGS::~BFGS(){}
+
+void BFGS::setLineSearch(const LineSearch& lineSearch) {
+    m_lineSearch = &lineSearch;
+}
+
+void BFGS::resetFactor(double scale) {
+    const size_t n = m_problem.dimension();
+    m_factor.compute(scale * Eigen::MatrixXd::Identity(n, n));
+}
+
+void BFGS::_run(){
+    const size_t n = m_problem.dimension();
+    Eigen::VectorXd gradient(n), gradientNew(n), d(n), xNew(n), step(n), change(n), Bs(n);
+    double value = m_problem.value(m_x.data());
+    m_problem.gradient(m_x.data(), gradient.data());
+    resetFactor(1.0);
+
+    m_iterations = 0;
+    m_evaluations = 0;
+    m_resets = 0;
+    while (m_iterations < m_maxIterations && gradient.norm() > m_tolerance) {
+        // B d = -g, two triangular solves with the factor
+        d = m_factor.solve(-gradient);
+        double slope = gradient.dot(d);
+        if (!(slope < 0)) {
+            resetFactor(1.0);
+            ++m_resets;
+            d = -gradient;
+            slope = -gradient.squaredNorm();
+        }
+        // B starts as the identity, so the first step has no natural length
+        double initialStep = m_iterations ? 1.0 : std::min(1.0, 1.0 / gradient.norm());
+
+        m_line.setLine(m_x.data(), d.data());
+        LineSearch::Result result = m_lineSearch->search(m_line, value, slope, initialStep);
+        m_evaluations += result.evaluations;
+        if (result.step == 0.0) break;
+
+        m_line.point(result.step, xNew.data());
+        if (result.hasGradient) m_line.gradient(gradientNew.data());
+        else m_problem.gradient(xNew.data(), gradientNew.data());
+        step = xNew - m_x;
+        change = gradientNew - gradient;
+        double curvature = change.dot(step);
+        if (curvature > 1e-12 * step.norm() * change.norm()) {
+            if (m_iterations == 0) {
+                // The identity has the wrong scale: replace it by (y.y / y.s) I before the first update
+                double scale = change.squaredNorm() / curvature;
+                resetFactor(scale);
+                Bs = scale * step;
+            } else {
+                // B s = step * B d = -step * g, no product with B needed
+                Bs = -result.step * gradient;
+            }
+            double sBs = step.dot(Bs);
+            // Update before downdate, so the factor stays positive definite in between
+            m_factor.rankUpdate(change, 1.0 / curvature);
+            m_factor.rankUpdate(Bs, -1.0 / sBs);
+            if (m_factor.info() != Eigen::Success) {
+                resetFactor(change.squaredNorm() / curvature);
+                ++m_resets;
+            }
+        }
+
+        m_x.swap(xNew);
+        gradient.swap(gradientNew);
+        value = result.value;
+        ++m_iterations;
+    }
+    std::cout<< "The BFGS found the minimum in "<< m_iterations <<" steps at "<<m_problem.describe(m_x)<< "\n";
+}
+
+const Eigen::VectorXd& BFGS::solution() const {
+    return m_x;
+}
+
+size_t BFGS::iterations() const {
+    return m_iterations;
+}
+
+size_t BFGS::evaluations() const {
+    return m_evaluations;
+}
+
+size_t BFGS::resets() const {
+    return m_resets;
+}
@@ -0,0 +1,122 @@
+#include "../../include/gradient/exact_line_search.hpp"
+#include "../../include/syntax_tree/polynomial.hpp"
+#include "../../include/Eigen/Eigenvalues"
+#include <cmath>
+
+ExactLineSearch::ExactLineSearch(const PreparedProblem& problem, int maxDegree)
+: m_degree(-1)
+, m_maxDegree(maxDegree)
+{
+    std::optional<Polynomial> polynomial = Polynomial::fromAST(problem.function(), problem.variables());
+    if (polynomial) m_degree = polynomial->degree();
+}
+
+bool ExactLineSearch::applicable() const {
+    return m_degree >= 0 && m_degree <= m_maxDegree;
+}
+
+int ExactLineSearch::degree() const {
+    return m_degree;
+}
+
+std::vector<double> ExactLineSearch::realRoots(const Eigen::VectorXd& coefficients) {
+    // Drop leading coefficients that are zero up to rounding
+    double scale = coefficients.cwiseAbs().maxCoeff();
+    Eigen::Index degree = coefficients.size() - 1;
+    while (degree > 0 && std::fabs(coefficients(degree)) <= 1e-12 * scale) --degree;
+    if (degree <= 0) return {};
+
+    // Companion matrix of the monic polynomial: its eigenvalues are the roots. It is already upper
+    // Hessenberg, so the real Schur form starts from it directly, without EigenSolver's reduction
+    Eigen::MatrixXd companion = Eigen::MatrixXd::Zero(degree, degree);
+    for (Eigen::Index j = 0; j < degree; ++j) companion(0, j) = -coefficients(degree - 1 - j) / coefficients(degree);
+    for (Eigen::Index i = 1; i < degree; ++i) companion(i, i - 1) = 1.0;
+    Eigen::RealSchur<Eigen::MatrixXd> schur(degree);
+    schur.computeFromHessenberg(companion, Eigen::MatrixXd::Identity(degree, degree), false);
+    if (schur.info() != Eigen::Success) return {};
+
+    // T is quasi-triangular: 1x1 blocks are real roots, 2x2 blocks complex pairs (kept when nearly real)
+    const Eigen::MatrixXd& T = schur.matrixT();
+    std::vector<double> roots;
+    for (Eigen::Index i = 0; i < degree; ++i) {
+        if (i + 1 == degree || T(i + 1, i) == 0.0) {
+            roots.push_back(T(i, i));
+            continue;
+        }
+        double p = 0.5 * (T(i, i) - T(i + 1, i + 1));
+        double z = p * p + T(i + 1, i) * T(i, i + 1);
+        double real = T(i + 1, i + 1) + p;
+        if (z >= 0) {
+            roots.push_back(real + std::sqrt(z));
+            roots.push_back(real - std::sqrt(z));
+        } else if (std::sqrt(-z) <= 1e-8 * (1 + std::fabs(real))) {
+            roots.push_back(real);
+        }
+        ++i;
+    }
+    return roots;
+}
+
+LineSearch::Result ExactLineSearch::search(LineRestriction& line, double value, double slope, double initialStep) const {
+    if (!applicable()) return m_fallback.search(line, value, slope, initialStep);
+
+    // phi(h*u) = sum_i c_i u^i: c_0 = phi(0), c_1 = h*phi'(0), the rest from samples at u in (0, 2)
+    const int k = std::max(m_degree, 1);
+    const double h = initialStep;
+    Eigen::MatrixXd vandermonde = Eigen::MatrixXd::Zero(k + 1, k + 1);
+    Eigen::VectorXd rhs(k + 1);
+    vandermonde(0, 0) = 1.0;
+    rhs(0) = value;
+    vandermonde(1, 1) = 1.0;
+    rhs(1) = h * slope;
+    size_t evaluations = 0;
+    for (int j = 0; j + 2 <= k; ++j) {
+        double u = 1 + std::cos(M_PI * (2 * j + 1) / (2 * (k - 1))); // Chebyshev nodes moved to (0, 2)
+        for (int i = 0; i <= k; ++i) vandermonde(j + 2, i) = std::pow(u, i);
+        rhs(j + 2) = line.value(h * u);
+        ++evaluations;
+    }
+    Eigen::VectorXd c = vandermonde.fullPivLu().solve(rhs);
+
+    // Critical points: roots of phi'; keep the minimizers and take the lowest
+    Eigen::VectorXd derivative(k);
+    for (int i = 1; i <= k; ++i) derivative(i - 1) = i * c(i);
+    auto polynomial = [&c](double u) {
+        double result = 0.0;
+        for (Eigen::Index i = c.size(); i-- > 0;) result = result * u + c(i);
+        return result;
+    };
+    double best = NAN, bestValue = INFINITY;
+    for (double u : realRoots(derivative)) {
+        double curvature = 0.0;
+        for (int i = k; i >= 2; --i) curvature = curvature * u + i * (i - 1) * c(i);
+        if (curvature <= 0) continue;
+        if (polynomial(u) < bestValue) {
+            best = u;
+            bestValue = polynomial(u);
+        }
+    }
+    // No minimizer along this line (phi unbounded below or constant)
+    if (std::isnan(best)) {
+        if (slope < 0) {
+            Result result = m_fallback.search(line, value, slope, initialStep);
+            result.evaluations += evaluations;
+            return result;
+        }
+        return {0.0, value, slope, evaluations, false, false};
+    }
+
+    double step = h * best;
+    double trial = line.value(step), trialSlope = line.derivative(step);
+    evaluations += 1;
+    // The fit is exact up to rounding: a step that is not at least as good as 0 means it was not
+    if (trial > value + 1e-10 * (1 + std::fabs(value))) {
+        if (slope < 0) {
+            Result result = m_fallback.search(line, value, slope, initialStep);
+            result.evaluations += evaluations;
+            return result;
+        }
+        return {0.0, value, slope, evaluations, false, false};
+    }
+    return {step, trial, trialSlope, evaluations, true, true};
+}
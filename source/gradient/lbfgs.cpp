@@ -0,0 +1,126 @@
+#include "../../include/gradient/lbfgs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+/** @brief Class constructor
+ * @param problem: the function prepared with its gradient (no Hessian is used),
+ * @param x0: the starting point,
+ * @param memory: number m of curvature pairs kept,
+ * @param tolerance: on the gradient norm,
+ * @param maxIterations: upper bound on the iterations.
+ */
+LBFGS::LBFGS(
+    const PreparedProblem& problem,
+    std::map<std::string, double> x0,
+    size_t memory,
+    double tolerance,
+    size_t maxIterations
+)
+: m_problem(problem)
+, m_line(problem)
+, m_lineSearch(&m_defaultLineSearch)
+, m_memory(std::max<size_t>(memory, 1))
+, m_tolerance(tolerance)
+, m_maxIterations(maxIterations)
+, m_x(problem.toEigen(x0))
+, m_S(problem.dimension(), m_memory)
+, m_Y(problem.dimension(), m_memory)
+, m_rho(m_memory)
+, m_alpha(m_memory)
+, m_pairs(0)
+, m_iterations(0)
+, m_evaluations(0)
+{}
+
+LBFGS::~LBFGS(){}
+
+void LBFGS::setLineSearch(const LineSearch& lineSearch) {
+    m_lineSearch = &lineSearch;
+}
+
+void LBFGS::direction(const Eigen::VectorXd& gradient, Eigen::VectorXd& d) {
+    d = -gradient;
+    size_t stored = std::min(m_pairs, m_memory);
+    // Newest to oldest
+    for (size_t k = 0; k < stored; ++k) {
+        size_t column = (m_pairs - 1 - k) % m_memory;
+        m_alpha(column) = m_rho(column) * m_S.col(column).dot(d);
+        d -= m_alpha(column) * m_Y.col(column);
+    }
+    // Initial inverse Hessian gamma*I, scaled by the newest pair
+    if (stored) {
+        size_t newest = (m_pairs - 1) % m_memory;
+        d *= m_S.col(newest).dot(m_Y.col(newest)) / m_Y.col(newest).squaredNorm();
+    }
+    // Oldest to newest
+    for (size_t k = stored; k-- > 0;) {
+        size_t column = (m_pairs - 1 - k) % m_memory;
+        double beta = m_rho(column) * m_Y.col(column).dot(d);
+        d += (m_alpha(column) - beta) * m_S.col(column);
+    }
+}
+
+void LBFGS::_run(){
+    const size_t n = m_problem.dimension();
+    Eigen::VectorXd gradient(n), gradientNew(n), d(n), xNew(n), step(n), change(n);
+    double value = m_problem.value(m_x.data());
+    m_problem.gradient(m_x.data(), gradient.data());
+
+    m_iterations = 0;
+    m_evaluations = 0;
+    m_pairs = 0;
+    while (m_iterations < m_maxIterations && gradient.norm() > m_tolerance) {
+        direction(gradient, d);
+        double slope = gradient.dot(d);
+        if (slope >= 0) {
+            // The curvature pairs went stale: start over from steepest descent
+            m_pairs = 0;
+            d = -gradient;
+            slope = -gradient.squaredNorm();
+        }
+        // Without curvature information the first step has no natural length
+        double initialStep = m_pairs ? 1.0 : std::min(1.0, 1.0 / gradient.norm());
+
+        m_line.setLine(m_x.data(), d.data());
+        LineSearch::Result result = m_lineSearch->search(m_line, value, slope, initialStep);
+        m_evaluations += result.evaluations;
+        if (result.step == 0.0) break;
+
+        m_line.point(result.step, xNew.data());
+        if (result.hasGradient) m_line.gradient(gradientNew.data());
+        else m_problem.gradient(xNew.data(), gradientNew.data());
+        // Only pairs with positive curvature keep the approximation positive definite
+        step = xNew - m_x;
+        change = gradientNew - gradient;
+        double curvature = change.dot(step);
+        if (curvature > 1e-12 * step.norm() * change.norm()) {
+            size_t column = m_pairs % m_memory; // overwrites the oldest pair once the buffer is full
+            m_S.col(column) = step;
+            m_Y.col(column) = change;
+            m_rho(column) = 1.0 / curvature;
+            ++m_pairs;
+        }
+
+        m_x.swap(xNew);
+        gradient.swap(gradientNew);
+        value = result.value;
+        ++m_iterations;
+    }
+    // One write for the whole line: DecomposedSolver runs a solver per component on pool threads at once
+    std::ostringstream line;
+    line << "The L-BFGS found the minimum in "<< m_iterations <<" steps at "<<m_problem.describe(m_x)<< "\n";
+    std::cout << line.str();
+}
+
+const Eigen::VectorXd& LBFGS::solution() const {
+    return m_x;
+}
+
+size_t LBFGS::iterations() const {
+    return m_iterations;
+}
+
+size_t LBFGS::evaluations() const {
+    return m_evaluations;
+}
@@ -0,0 +1,23 @@
+#include "../../include/gradient/line_search.hpp"
+#include <stdexcept>
+
+BacktrackingLineSearch::BacktrackingLineSearch(double c1, double shrink, double minStep)
+: m_c1(c1)
+, m_shrink(shrink)
+, m_minStep(minStep)
+{
+    if (!(0 < c1 && c1 < 1 && 0 < shrink && shrink < 1)) throw std::invalid_argument("BacktrackingLineSearch: needs 0 < c1, shrink < 1");
+}
+
+LineSearch::Result BacktrackingLineSearch::search(LineRestriction& line, double value, double slope, double initialStep) const {
+    double step = initialStep;
+    double trial = line.value(step);
+    size_t evaluations = 1;
+    while (!(trial <= value + m_c1 * step * slope)) {
+        if (step * m_shrink < m_minStep) return {step, trial, 0.0, evaluations, false, false};
+        step *= m_shrink;
+        trial = line.value(step);
+        ++evaluations;
+    }
+    return {step, trial, 0.0, evaluations, true, false};
+}
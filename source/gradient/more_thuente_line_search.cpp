@@ -0,0 +1,159 @@
+#include "../../include/gradient/more_thuente_line_search.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// One end of the interval of uncertainty: step, phi and phi'
+struct End {
+    double step, value, slope;
+};
+
+double largest(double a, double b, double c) {
+    return std::max(std::fabs(a), std::max(std::fabs(b), std::fabs(c)));
+}
+
+/* dcstep: the next trial step from the ends x (best so far) and y and the trial t,
+ * then the update of the interval. The four cases are those of Moré & Thuente, section 4. */
+void nextStep(End& x, End& y, End& t, bool& bracketed, double minStep, double maxStep) {
+    double sign = t.slope * (x.slope / std::fabs(x.slope));
+    double next;
+    if (t.value > x.value) {
+        // 1: higher value, the minimizer is bracketed. Cubic step if it is closer to x, else the average
+        double theta = 3 * (x.value - t.value) / (t.step - x.step) + x.slope + t.slope;
+        double s = largest(theta, x.slope, t.slope);
+        double gamma = s * std::sqrt((theta / s) * (theta / s) - (x.slope / s) * (t.slope / s));
+        if (t.step < x.step) gamma = -gamma;
+        double p = (gamma - x.slope) + theta;
+        double q = ((gamma - x.slope) + gamma) + t.slope;
+        double cubic = x.step + p / q * (t.step - x.step);
+        double quadratic = x.step + x.slope / ((x.value - t.value) / (t.step - x.step) + x.slope) / 2 * (t.step - x.step);
+        next = std::fabs(cubic - x.step) < std::fabs(quadratic - x.step) ? cubic : cubic + (quadratic - cubic) / 2;
+        bracketed = true;
+    } else if (sign < 0) {
+        // 2: lower value, derivatives of opposite sign. Bracketed, the step farther from t
+        double theta = 3 * (x.value - t.value) / (t.step - x.step) + x.slope + t.slope;
+        double s = largest(theta, x.slope, t.slope);
+        double gamma = s * std::sqrt((theta / s) * (theta / s) - (x.slope / s) * (t.slope / s));
+        if (t.step > x.step) gamma = -gamma;
+        double p = (gamma - t.slope) + theta;
+        double q = ((gamma - t.slope) + gamma) + x.slope;
+        double cubic = t.step + p / q * (x.step - t.step);
+        double secant = t.step + t.slope / (t.slope - x.slope) * (x.step - t.step);
+        next = std::fabs(cubic - t.step) > std::fabs(secant - t.step) ? cubic : secant;
+        bracketed = true;
+    } else if (std::fabs(t.slope) < std::fabs(x.slope)) {
+        // 3: lower value, same sign, the derivative decreases in magnitude
+        double theta = 3 * (x.value - t.value) / (t.step - x.step) + x.slope + t.slope;
+        double s = largest(theta, x.slope, t.slope);
+        double gamma = s * std::sqrt(std::max(0.0, (theta / s) * (theta / s) - (x.slope / s) * (t.slope / s)));
+        if (t.step > x.step) gamma = -gamma;
+        double p = (gamma - t.slope) + theta;
+        double q = (gamma + (x.slope - t.slope)) + gamma;
+        double r = p / q;
+        double cubic = r < 0 && gamma != 0 ? t.step + r * (x.step - t.step) : (t.step > x.step ? maxStep : minStep);
+        double secant = t.step + t.slope / (t.slope - x.slope) * (x.step - t.step);
+        if (bracketed) {
+            next = std::fabs(cubic - t.step) < std::fabs(secant - t.step) ? cubic : secant;
+            next = t.step > x.step ? std::min(t.step + 0.66 * (y.step - t.step), next) : std::max(t.step + 0.66 * (y.step - t.step), next);
+        } else {
+            next = std::fabs(cubic - t.step) > std::fabs(secant - t.step) ? cubic : secant;
+            next = std::max(minStep, std::min(maxStep, next));
+        }
+    } else {
+        // 4: lower value, same sign, the derivative does not decrease. Cubic step towards y, or the limit
+        if (bracketed) {
+            double theta = 3 * (t.value - y.value) / (y.step - t.step) + y.slope + t.slope;
+            double s = largest(theta, y.slope, t.slope);
+            double gamma = s * std::sqrt((theta / s) * (theta / s) - (y.slope / s) * (t.slope / s));
+            if (t.step > y.step) gamma = -gamma;
+            double p = (gamma - t.slope) + theta;
+            double q = ((gamma - t.slope) + gamma) + y.slope;
+            next = t.step + p / q * (y.step - t.step);
+        } else {
+            next = t.step > x.step ? maxStep : minStep;
+        }
+    }
+
+    // The new interval
+    if (t.value > x.value) {
+        y = t;
+    } else {
+        if (sign < 0) y = x;
+        x = t;
+    }
+    t.step = next;
+}
+
+} // namespace
+
+MoreThuenteLineSearch::MoreThuenteLineSearch(double c1, double c2, double xtol, size_t maxEvaluations, double minStep, double maxStep)
+: m_c1(c1)
+, m_c2(c2)
+, m_xtol(xtol)
+, m_maxEvaluations(maxEvaluations)
+, m_minStep(minStep)
+, m_maxStep(maxStep)
+{
+    if (!(0 < c1 && c1 < c2 && c2 < 1)) throw std::invalid_argument("MoreThuenteLineSearch: needs 0 < c1 < c2 < 1");
+    if (!(0 <= minStep && minStep < maxStep)) throw std::invalid_argument("MoreThuenteLineSearch: needs 0 <= minStep < maxStep");
+}
+
+LineSearch::Result MoreThuenteLineSearch::search(LineRestriction& line, double value, double slope, double initialStep) const {
+    if (slope >= 0) throw std::invalid_argument("MoreThuenteLineSearch: not a descent direction");
+    const double decrease = m_c1 * slope; // slope of the sufficient decrease line
+    bool bracketed = false, modified = true; // modified: still on the auxiliary function psi(s) = phi(s) - phi(0) - s*decrease
+    double width = m_maxStep - m_minStep, previousWidth = 2 * width;
+    End x{0.0, value, slope}, y{0.0, value, slope};
+    double low = 0.0, high = initialStep * 5;
+    double step = std::max(m_minStep, std::min(m_maxStep, initialStep));
+
+    size_t evaluations = 0;
+    for (;;) {
+        End t{step, line.value(step), line.derivative(step)};
+        ++evaluations;
+        double sufficient = value + step * decrease;
+        if (modified && t.value <= sufficient && t.slope >= 0) modified = false;
+
+        if (t.value <= sufficient && std::fabs(t.slope) <= -m_c2 * slope) return {t.step, t.value, t.slope, evaluations, true, true};
+        bool stuck = (bracketed && (step <= low || step >= high)) || (bracketed && high - low <= m_xtol * high)
+            || (step == m_maxStep && t.value <= sufficient && t.slope <= decrease)
+            || (step == m_minStep && (t.value > sufficient || t.slope >= decrease));
+        if (stuck || evaluations >= m_maxEvaluations) {
+            // Give up with the best point: the trial if it lowered phi below the best end, else that end
+            if (t.value <= sufficient && t.value <= x.value) return {t.step, t.value, t.slope, evaluations, false, true};
+            if (x.step == 0.0) return {0.0, value, slope, evaluations, false, false};
+            End best{x.step, line.value(x.step), line.derivative(x.step)};
+            return {best.step, best.value, best.slope, evaluations + 1, false, true};
+        }
+
+        if (modified && t.value <= x.value && t.value > sufficient) {
+            // psi instead of phi while no step has a lower value and a nonnegative derivative
+            End xm{x.step, x.value - x.step * decrease, x.slope - decrease};
+            End ym{y.step, y.value - y.step * decrease, y.slope - decrease};
+            End tm{t.step, t.value - t.step * decrease, t.slope - decrease};
+            nextStep(xm, ym, tm, bracketed, low, high);
+            x = {xm.step, xm.value + xm.step * decrease, xm.slope + decrease};
+            y = {ym.step, ym.value + ym.step * decrease, ym.slope + decrease};
+            step = tm.step;
+        } else {
+            nextStep(x, y, t, bracketed, low, high);
+            step = t.step;
+        }
+
+        // Bisect when the interval did not shrink enough over two steps
+        if (bracketed) {
+            if (std::fabs(y.step - x.step) >= 0.66 * previousWidth) step = x.step + 0.5 * (y.step - x.step);
+            previousWidth = width;
+            width = std::fabs(y.step - x.step);
+            low = std::min(x.step, y.step);
+            high = std::max(x.step, y.step);
+        } else {
+            low = step + 1.1 * (step - x.step);
+            high = step + 4.0 * (step - x.step);
+        }
+        step = std::max(m_minStep, std::min(m_maxStep, step));
+        if (bracketed && (step <= low || step >= high || high - low <= m_xtol * high)) step = x.step;
+    }
+}
@@ -0,0 +1,169 @@
+#include "../../include/gradient/nelder_mead.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+NelderMead::Parameters NelderMead::Parameters::standard() {
+    return {1.0, 2.0, 0.5, 0.5};
+}
+
+NelderMead::Parameters NelderMead::Parameters::adaptive(size_t dimension) {
+    double n = static_cast<double>(std::max<size_t>(dimension, 2));
+    return {1.0, 1.0 + 2.0 / n, 0.75 - 1.0 / (2.0 * n), 1.0 - 1.0 / n};
+}
+
+/** @brief Class constructor
+ * @param function: the objective, it is compiled but never differentiated,
+ * @param x0: the starting point, its keys are the variables; throws std::invalid_argument if it is empty,
+ * @param pool: runs the evaluations of an iteration concurrently,
+ * @param adaptive: dimension dependent coefficients instead of the standard ones,
+ * @param tolerance: on the spread of the values and of the vertices,
+ * @param maxIterations: upper bound on the iterations, 0 for 200 per variable.
+ */
+NelderMead::NelderMead(
+    Node* function,
+    std::map<std::string, double> x0,
+    ThreadPool& pool,
+    bool adaptive,
+    double tolerance,
+    size_t maxIterations
+)
+: m_pool(pool)
+, m_adaptive(adaptive)
+, m_tolerance(tolerance)
+, m_x(x0.size())
+, m_value(NAN)
+, m_iterations(0)
+, m_evaluations(0)
+, m_shrinks(0)
+, m_scratch(pool.size())
+{
+    // The simplex needs at least one variable: with none, n - 1 below wraps around
+    if (x0.empty()) throw std::invalid_argument("NelderMead: needs at least one variable");
+    for (const auto& [var, value] : x0) {
+        m_x(m_variables.size()) = value;
+        m_variables.push_back(var);
+    }
+    m_program = Program(function, m_variables);
+    m_parameters = adaptive ? Parameters::adaptive(m_variables.size()) : Parameters::standard();
+    m_maxIterations = maxIterations ? maxIterations : 200 * m_variables.size();
+}
+
+NelderMead::~NelderMead(){}
+
+void NelderMead::evaluate(const std::vector<const double*>& points, double* values) {
+    m_pool.run(points.size(), [&](size_t k, size_t worker) {
+        double value = m_program.evaluate(points[k], m_scratch[worker]);
+        values[k] = std::isnan(value) ? INFINITY : value;
+    });
+    m_evaluations += points.size();
+}
+
+double NelderMead::evaluate(const Eigen::VectorXd& point) {
+    double value;
+    evaluate({point.data()}, &value);
+    return value;
+}
+
+void NelderMead::_run(){
+    const size_t n = m_variables.size();
+    const Parameters& p = m_parameters;
+    m_iterations = 0;
+    m_evaluations = 0;
+    m_shrinks = 0;
+
+    // Starting simplex: x0 and one vertex per coordinate, 5% away (0.00025 for zero coordinates)
+    Eigen::MatrixXd simplex = m_x.replicate(1, n + 1);
+    for (size_t i = 0; i < n; ++i) simplex(i, i + 1) = m_x(i) != 0 ? 1.05 * m_x(i) : 0.00025;
+    Eigen::VectorXd values(n + 1);
+    std::vector<const double*> points;
+    for (size_t k = 0; k <= n; ++k) points.push_back(simplex.col(k).data());
+    evaluate(points, values.data());
+
+    std::vector<size_t> order(n + 1);
+    Eigen::VectorXd centroid(n), reflected(n), expanded(n), outside(n), inside(n);
+    const bool speculative = m_pool.size() > 1;
+    for (; m_iterations < m_maxIterations; ++m_iterations) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values(a) < values(b); });
+        size_t best = order[0], worst = order[n], secondWorst = order[n - 1];
+
+        double valueSpread = values(worst) - values(best);
+        double vertexSpread = (simplex.colwise() - simplex.col(best)).cwiseAbs().maxCoeff();
+        if (valueSpread <= m_tolerance && vertexSpread <= m_tolerance) break;
+
+        centroid = (simplex.rowwise().sum() - simplex.col(worst)) / n;
+        reflected = centroid + p.reflection * (centroid - simplex.col(worst));
+        expanded = centroid + p.expansion * (reflected - centroid);
+        outside = centroid + p.contraction * (reflected - centroid);
+        inside = centroid + p.contraction * (simplex.col(worst) - centroid);
+
+        // Every trial point of the iteration at once, or each one only when the rules get to it
+        double trial[4] = {NAN, NAN, NAN, NAN};
+        if (speculative) evaluate({reflected.data(), expanded.data(), outside.data(), inside.data()}, trial);
+        auto fr = [&]() { return std::isnan(trial[0]) ? trial[0] = evaluate(reflected) : trial[0]; };
+        auto fe = [&]() { return std::isnan(trial[1]) ? trial[1] = evaluate(expanded) : trial[1]; };
+        auto foc = [&]() { return std::isnan(trial[2]) ? trial[2] = evaluate(outside) : trial[2]; };
+        auto fic = [&]() { return std::isnan(trial[3]) ? trial[3] = evaluate(inside) : trial[3]; };
+
+        const Eigen::VectorXd* accepted = nullptr;
+        double acceptedValue = 0.0;
+        if (fr() < values(best)) {
+            if (fe() < fr()) { accepted = &expanded; acceptedValue = fe(); }
+            else { accepted = &reflected; acceptedValue = fr(); }
+        } else if (fr() < values(secondWorst)) {
+            accepted = &reflected; acceptedValue = fr();
+        } else if (fr() < values(worst)) {
+            if (foc() <= fr()) { accepted = &outside; acceptedValue = foc(); }
+        } else {
+            if (fic() < values(worst)) { accepted = &inside; acceptedValue = fic(); }
+        }
+
+        if (accepted) {
+            simplex.col(worst) = *accepted;
+            values(worst) = acceptedValue;
+            continue;
+        }
+        // Shrink towards the best vertex: n new vertices, evaluated together
+        points.clear();
+        for (size_t k = 0; k <= n; ++k) {
+            if (k == best) continue;
+            simplex.col(k) = simplex.col(best) + p.shrink * (simplex.col(k) - simplex.col(best));
+            points.push_back(simplex.col(k).data());
+        }
+        std::vector<double> shrunk(n);
+        evaluate(points, shrunk.data());
+        for (size_t k = 0, j = 0; k <= n; ++k) {
+            if (k != best) values(k) = shrunk[j++];
+        }
+        ++m_shrinks;
+    }
+
+    Eigen::Index best;
+    m_value = values.minCoeff(&best);
+    m_x = simplex.col(best);
+    std::cout << "The Nelder-Mead " << (m_adaptive ? "(adaptive) " : "") << "found the minimum in "
+              << m_iterations << " steps (" << m_evaluations << " evaluations) at "
+              << PreparedProblem::describe(m_variables, m_x) << "\n";
+}
+
+const Eigen::VectorXd& NelderMead::solution() const {
+    return m_x;
+}
+
+double NelderMead::value() const {
+    return m_value;
+}
+
+size_t NelderMead::iterations() const {
+    return m_iterations;
+}
+
+size_t NelderMead::evaluations() const {
+    return m_evaluations;
+}
+
+size_t NelderMead::shrinks() const {
+    return m_shrinks;
+}
@@ -1,42 +1,113 @@
 #include "../../include/gradient/newton.hpp"
+#include <algorithm>
+#include <chrono>
 
 /** @brief Class constructor
- * @param function: as a Node*,
- * @param tolerance as a double.
+ * @param problem: the function prepared with its gradient (and, if available, its Hessian),
+ * @param x0: the starting point,
+ * @param tolerance: on the gradient norm and on the step length,
+ * @param maxIterations: upper bound on the iterations.
  */
 Newton::Newton(
-    Node* function,
-    std::map<std::string, double> x0
+    const PreparedProblem& problem,
+    std::map<std::string, double> x0,
+    double tolerance,
+    size_t maxIterations
 )
-: m_function(function)
-, m_x0(x0)
+: m_problem(problem)
+, m_lazyHessian(problem)
+, m_context(problem)
+, m_line(problem)
+, m_lineSearch(&m_defaultLineSearch)
+, m_tolerance(tolerance)
+, m_maxIterations(maxIterations)
+, m_x(problem.toEigen(x0))
+, m_iterations(0)
 {}
 
 /** @brief Class Destructor */
 Newton::~Newton(){}
 
-void Newton::_run(){
+void Newton::setLineSearch(const LineSearch& lineSearch) {
+    m_lineSearch = &lineSearch;
+}
 
-    auto gradient = this->diff.computeJacobian(m_function, m_x0);
-    auto hessian = this->diff.computeHessian(m_function, m_x0);
+std::optional<double> Newton::direction(const Eigen::MatrixXd& hessian, const Eigen::VectorXd& gradient, Eigen::VectorXd& d) const {
+    Eigen::MatrixXd shifted;
+    return NewtonStep::shift(hessian.data(), hessian.size(), hessian.diagonal().minCoeff(), [&](double tau) {
+        if (tau == 0.0) {
+            // Positive definite with some margin: the plain Newton step
+            Eigen::LDLT<Eigen::MatrixXd> ldlt(hessian);
+            if (ldlt.info() != Eigen::Success || !NewtonStep::positive(ldlt.vectorD())) return false;
+            d = -ldlt.solve(gradient);
+            return true;
+        }
+        shifted = hessian;
+        shifted.diagonal().array() += tau;
+        Eigen::LLT<Eigen::MatrixXd> llt(shifted);
+        if (llt.info() != Eigen::Success) return false;
+        d = -llt.solve(gradient);
+        return true;
+    });
+}
 
-    if (hessian.determinant() != 0){
-        Eigen::MatrixXd hessianInverse = hessian.inverse();
+void Newton::_run(){
+    const size_t n = m_problem.dimension();
+    Eigen::VectorXd gradient(n), d(n), xNew(n);
+    Eigen::MatrixXd hessian(n, n);
+    m_iterations = 0;
+    m_factorizationSeconds.clear();
+    m_shifts.clear();
 
-        // Convert m_x0 (std::map) to an Eigen vector
-        Eigen::VectorXd x0Vector(m_x0.size());
-        int i = 0;
-        x0Vector[0] = m_x0["x"];
-        x0Vector[1] = m_x0["y"];
+    m_context.setPoint(m_x.data());
+    double value = m_context.value();
+    m_context.gradient(gradient.data());
+    while (m_iterations < m_maxIterations && gradient.norm() > m_tolerance) {
+        // Without a prepared Hessian the second derivatives are only derived here, when Newton runs.
+        // The Hessian is symmetric, so the row major output can be read column major.
+        if (m_problem.hasHessian()) m_context.hessian(hessian.data());
+        else hessian = m_lazyHessian.full(m_x.data());
 
-        // Perform the update: x_new = x0 - inv(H) * G
-        // This method takes us to a minima instantly. no need for tolerance check.
-        Eigen::VectorXd x_newVector = x0Vector - hessianInverse * gradient.transpose(); // See if gradient needs transposed.
+        auto start = std::chrono::steady_clock::now();
+        std::optional<double> tau = direction(hessian, gradient, d);
+        if (!tau) {
+            NewtonStep::reportFailure(m_iterations, gradient.norm());
+            break;
+        }
+        m_factorizationSeconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        m_shifts.push_back(*tau);
 
-        // Update x_new (which is a std::map) with the new values
-        std::cout<< "The Newton found interval in 1 step is a: " << x_newVector[0] << " and b: " << x_newVector[1] << "\n";
-    }
-    else{
-        std::cerr << "Hessian is singular (non-invertible)." << "\n";
+        // The full Newton step first, by default Armijo backtracking from there
+        m_line.setLine(m_x.data(), d.data());
+        LineSearch::Result result = m_lineSearch->search(m_line, value, gradient.dot(d), 1.0);
+        double step = result.step;
+        if (step == 0.0) break;
+        m_line.point(step, xNew.data());
+        double stepLength = step * d.norm();
+        NewtonStep::report(m_iterations, gradient.norm(), step, *tau, m_factorizationSeconds.back());
+
+        m_x.swap(xNew);
+        m_context.setPoint(m_x.data());
+        value = m_context.value();
+        m_context.gradient(gradient.data());
+        ++m_iterations;
+        if (stepLength <= m_tolerance * (1 + m_x.norm())) break;
     }
+    std::cout<< "The Newton found the minimum in " << m_iterations << " steps at " << m_problem.describe(m_x) << "\n";
+}
+
+const Eigen::VectorXd& Newton::solution() const {
+    return m_x;
+}
+
+size_t Newton::iterations() const {
+    return m_iterations;
+}
+
+const std::vector<double>& Newton::factorizationSeconds() const {
+    return m_factorizationSeconds;
+}
+
+const std::vector<double>& Newton::shifts() const {
+    return m_shifts;
 }
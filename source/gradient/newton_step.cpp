@@ -0,0 +1,34 @@
+#include "../../include/gradient/newton_step.hpp"
+#include <algorithm>
+#include <cmath>
+
+std::optional<double> NewtonStep::shift(const double* values, size_t count, double minDiagonal,
+                                        const std::function<bool(double tau)>& factorize) {
+    double largest = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        if (!std::isfinite(values[k])) return std::nullopt;
+        largest = std::max(largest, std::fabs(values[k]));
+    }
+    if (factorize(0.0)) return 0.0;
+
+    const double beta = 1e-3 * std::max(1.0, largest);
+    double tau = minDiagonal > 0 ? beta : beta - minDiagonal;
+    for (int attempt = 0; attempt < MAX_SHIFTS; ++attempt, tau *= 2) {
+        if (factorize(tau)) return tau;
+    }
+    return std::nullopt;
+}
+
+bool NewtonStep::positive(const Eigen::VectorXd& D) {
+    return D.size() == 0 || D.minCoeff() > 1e-10 * std::max(1.0, D.cwiseAbs().maxCoeff());
+}
+
+void NewtonStep::report(size_t iteration, double gradientNorm, double step, double tau, double seconds) {
+    std::cout << "iteration " << iteration << ": ||g|| = " << gradientNorm << ", step " << step
+              << ", shift " << tau << ", factorization " << seconds << " s" << "\n";
+}
+
+void NewtonStep::reportFailure(size_t iteration, double gradientNorm) {
+    std::cout << "iteration " << iteration << ": ||g|| = " << gradientNorm
+              << ", the Hessian is not finite or no shift made it positive definite, stopping" << "\n";
+}
@@ -0,0 +1,112 @@
+#include "../../include/gradient/sparse_newton.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+/** @brief Class constructor
+ * @param problem: the function prepared with its gradient, its Hessian is assembled separately,
+ * @param x0: the starting point,
+ * @param tolerance: on the gradient norm and on the step length,
+ * @param maxIterations: upper bound on the iterations.
+ */
+SparseNewton::SparseNewton(
+    const PreparedProblem& problem,
+    std::map<std::string, double> x0,
+    double tolerance,
+    size_t maxIterations
+)
+: m_problem(problem)
+, m_elementHessian(problem.function(), problem.variables(), ElementHessian::LOWER)
+, m_line(problem)
+, m_lineSearch(&m_defaultLineSearch)
+, m_tolerance(tolerance)
+, m_maxIterations(maxIterations)
+, m_x(problem.toEigen(x0))
+, m_iterations(0)
+, m_analysisSeconds(0.0)
+{}
+
+SparseNewton::~SparseNewton(){}
+
+void SparseNewton::setLineSearch(const LineSearch& lineSearch) {
+    m_lineSearch = &lineSearch;
+}
+
+std::optional<double> SparseNewton::factorize() {
+    Eigen::VectorXd diagonal = m_hessian.diagonal();
+    return NewtonStep::shift(m_hessian.valuePtr(), m_hessian.nonZeros(), diagonal.size() ? diagonal.minCoeff() : 0.0, [this](double tau) {
+        m_solver.setShift(tau);
+        m_solver.factorize(m_hessian);
+        return m_solver.info() == Eigen::Success && NewtonStep::positive(m_solver.vectorD());
+    });
+}
+
+void SparseNewton::_run(){
+    const size_t n = m_problem.dimension();
+    Eigen::VectorXd gradient(n), d(n), xNew(n);
+    m_iterations = 0;
+    m_factorizationSeconds.clear();
+
+    // The pattern is fixed by the elements: order and analyze it once for the whole run
+    m_elementHessian.assemble(m_x.data(), m_hessian);
+    auto start = std::chrono::steady_clock::now();
+    m_solver.analyzePattern(m_hessian);
+    m_analysisSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double value = m_problem.value(m_x.data());
+    m_problem.gradient(m_x.data(), gradient.data());
+    while (m_iterations < m_maxIterations && gradient.norm() > m_tolerance) {
+        // Same pattern, so assemble() writes into the values the analysis was made for
+        if (m_iterations) m_elementHessian.assemble(m_x.data(), m_hessian);
+        start = std::chrono::steady_clock::now();
+        std::optional<double> tau = factorize();
+        if (!tau) {
+            NewtonStep::reportFailure(m_iterations, gradient.norm());
+            break;
+        }
+        m_factorizationSeconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        d = -m_solver.solve(gradient);
+
+        // The full Newton step first, by default Armijo backtracking from there
+        m_line.setLine(m_x.data(), d.data());
+        LineSearch::Result result = m_lineSearch->search(m_line, value, gradient.dot(d), 1.0);
+        double step = result.step;
+        if (step == 0.0) break;
+        m_line.point(step, xNew.data());
+        double stepLength = step * d.norm();
+        NewtonStep::report(m_iterations, gradient.norm(), step, *tau, m_factorizationSeconds.back());
+
+        m_x.swap(xNew);
+        value = result.value;
+        if (result.hasGradient) m_line.gradient(gradient.data());
+        else m_problem.gradient(m_x.data(), gradient.data());
+        ++m_iterations;
+        if (stepLength <= m_tolerance * (1 + m_x.norm())) break;
+    }
+    std::cout<< "The sparse Newton found the minimum in " << m_iterations << " steps (analysis " << m_analysisSeconds
+             << " s, " << factorNonZeros() << " nonzeros in L) at " << m_problem.describe(m_x) << "\n";
+}
+
+const Eigen::VectorXd& SparseNewton::solution() const {
+    return m_x;
+}
+
+size_t SparseNewton::iterations() const {
+    return m_iterations;
+}
+
+double SparseNewton::analysisSeconds() const {
+    return m_analysisSeconds;
+}
+
+const std::vector<double>& SparseNewton::factorizationSeconds() const {
+    return m_factorizationSeconds;
+}
+
+size_t SparseNewton::hessianNonZeros() const {
+    return m_hessian.nonZeros();
+}
+
+size_t SparseNewton::factorNonZeros() const {
+    return m_iterations ? static_cast<size_t>(m_solver.matrixL().nestedExpression().nonZeros()) : 0;
+}
@@ -2,64 +2,70 @@
 
 /** @brief
  * Class constructor
- * @param function - the function in tree form,
+ * @param problem - the function with its gradient, prepared once,
  * @param tolerance - the tolerance we set in order to tell when we've reachef the final point,
- * @param a - lower bound,
- * @param b - upper bound,
- * @param x0 - the starting point.
+ * @param a - lower end of the first step interval,
+ * @param b - upper end of the first step interval, later brackets start from the previous step,
+ * @param x0 - the starting point,
+ * @param maxIterations - upper bound on the iterations.
  */
 Steepest_Descent::Steepest_Descent(
-    Node* function,
-    std::string expression,
+    const PreparedProblem& problem,
     double tolerance,
     double a,
     double b,
-    std::map<std::string, double> x0
+    std::map<std::string, double> x0,
+    size_t maxIterations
 )
-: m_function(function)
-, m_expression(expression)
+: m_problem(problem)
+, m_line(problem)
+, m_lineSearch(nullptr)
+, m_exact(problem)
 , m_tolerance(tolerance)
+, m_maxIterations(maxIterations)
+, d(b-a)
 , a(a)
 , b(b)
-, d(b-a)
-, x_curr{{"x", 0.0}, {"y", 0.0}}
-, x_new(x0)
+, step(0.0)
+, x_new(problem.toEigen(x0))
+, x_curr(Eigen::VectorXd::Zero(problem.dimension()))
+, gradient(problem.dimension())
 {}
 
 Steepest_Descent::~Steepest_Descent(){}
 
-// Lambda to add "+" before positive numbers in order for the parser to know in cases like (-x+y)
-auto to_string_with_sign = [](double value) -> std::string {
-    if (value >= 0) {
-        return "+" + std::to_string(value);  // Add "+" sign for positive numbers
-    } else {
-        return std::to_string(value);  // No "+" for negative numbers
-    }
-};
+void Steepest_Descent::setLineSearch(const LineSearch& lineSearch){
+    m_lineSearch = &lineSearch;
+}
 
 void Steepest_Descent::_run(){
-    unsigned int k = 0;
-    std::string function_str = m_expression;
-    
-    while(differentiator.norm(x_curr, x_new) > m_tolerance){
+    size_t k = 0;
+    m_problem.gradient(x_new.data(), gradient.data());
+
+    // A short step is no sign of a minimum (on Rosenbrock's valley the steps shrink long before
+    // it): stop on the gradient, like the quasi-Newton solvers
+    while(k < m_maxIterations && gradient.norm() > m_tolerance){
         x_curr = x_new;
-        auto gradient = this->differentiator.computeJacobian(m_function, x_curr);
 
-        std::string grad_x = "("+std::to_string(-gradient(0, 0)) +"*s" + to_string_with_sign(x_curr["x"])+")";  // Gradient at x
-        std::string grad_y = "("+std::to_string(-gradient(0, 1)) +"*s" + to_string_with_sign(x_curr["y"])+")";  // Gradient at y
-        // Replace "x" with grad_x and "y" with grad_y in the function
-        function_str = tokenizer.replace_all(m_expression, "x", grad_x); // I want to replace variable "x" with d/dx * s
-        function_str = tokenizer.replace_all(m_expression, "y", grad_y); // replace variable "y" with d/dy * s
-        auto tokens = this->tokenizer.tokenize(function_str);
-        auto outputQueue = this->tokenizer.ShuntingYard(tokens);
-        auto result = tokenizer.golden_section(outputQueue, this->a, this->b, this->m_tolerance/10, "s");
-        this->a = result.first; this->b = result.second;
-        step = (this->a + this->b)/2;
-        x_new["x"] = -gradient(0,0)*step + x_curr["x"];
-        x_new["y"] = -gradient(0,1)*step + x_curr["y"];
+        // phi(s) = f(x - s * gradient), evaluated on the compiled objective
+        Eigen::VectorXd direction = -gradient;
+        m_line.setLine(x_curr.data(), direction.data());
+        if (m_lineSearch || m_exact.applicable()) {
+            // The last accepted step is the first guess for the next one; polynomials get the exact step
+            const LineSearch& search = m_lineSearch ? *m_lineSearch : m_exact;
+            LineSearch::Result result = search.search(m_line, m_problem.value(x_curr.data()), -gradient.squaredNorm(), step > 0 ? step : 1.0);
+            step = result.step;
+        } else {
+            // Brent from [a, b] on the first iteration, from the last step afterwards: the bracket
+            // grows or shrinks with the problem instead of narrowing for good
+            double first = step > 0 ? 0.0 : this->a, second = step > 0 ? step : this->b;
+            Token::Minimum minimum = tokenizer.brent([this](double s) { return m_line.value(s); }, first, second, this->m_tolerance/10);
+            step = minimum.x;
+        }
+        if (step == 0.0) break;
+        x_new = x_curr + step*direction;
+        m_problem.gradient(x_new.data(), gradient.data());
         k++;
     }
-    double final_a = x_new["x"];
-    double final_b = x_new["y"];
-    std::cout<< "The steepest descent found interval in "<< k <<" steps is a: "<<final_a<<" and b: "<<final_b<< std::endl;
-}
\ No newline at end of file
+    std::cout<< "The steepest descent found the minimum in "<< k <<" steps at "<<m_problem.describe(x_new)<< std::endl;
+}
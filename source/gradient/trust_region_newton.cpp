@@ -0,0 +1,120 @@
+#include "../../include/gradient/trust_region_newton.hpp"
+#include <algorithm>
+#include <cmath>
+
+/** @brief Class constructor
+ * @param problem: the function prepared with its gradient (the Hessian is not needed),
+ * @param x0: the starting point,
+ * @param tolerance: on the gradient norm,
+ * @param maxIterations: upper bound on the outer iterations,
+ * @param radius: initial trust radius,
+ * @param maxRadius: the radius never grows beyond it.
+ */
+TrustRegionNewton::TrustRegionNewton(
+    const PreparedProblem& problem,
+    std::map<std::string, double> x0,
+    double tolerance,
+    size_t maxIterations,
+    double radius,
+    double maxRadius
+)
+: m_problem(problem)
+, m_tolerance(tolerance)
+, m_maxIterations(maxIterations)
+, m_radius(radius)
+, m_maxRadius(maxRadius)
+, m_x(problem.toEigen(x0))
+, m_iterations(0)
+, m_products(0)
+{}
+
+TrustRegionNewton::~TrustRegionNewton(){}
+
+// Positive tau with ||z + tau*d|| = radius, z is inside the region
+static double toBoundary(const Eigen::VectorXd& z, const Eigen::VectorXd& d, double radius) {
+    double a = d.squaredNorm(), b = 2 * z.dot(d), c = z.squaredNorm() - radius * radius;
+    return (-b + std::sqrt(std::max(b * b - 4 * a * c, 0.0))) / (2 * a);
+}
+
+bool TrustRegionNewton::steihaug(const Eigen::VectorXd& gradient, Eigen::VectorXd& p, Eigen::VectorXd& Hp) {
+    const size_t n = m_problem.dimension();
+    // Forcing term min(0.5, sqrt||g||)*||g|| gives superlinear convergence near the minimum
+    double gradientNorm = gradient.norm();
+    double tolerance = std::min(0.5, std::sqrt(gradientNorm)) * gradientNorm;
+    Eigen::VectorXd r = gradient, d = -gradient, Hd(n);
+    p.setZero(n);
+    Hp.setZero(n);
+    double rr = r.squaredNorm();
+    for (size_t j = 0; j < n; ++j) {
+        m_problem.hessianVector(m_x.data(), d.data(), Hd.data());
+        ++m_products;
+        double curvature = d.dot(Hd);
+        if (curvature <= 0) {
+            // Negative curvature: follow d to the boundary, the model decreases all the way
+            double tau = toBoundary(p, d, m_radius);
+            p += tau * d;
+            Hp += tau * Hd;
+            return true;
+        }
+        double alpha = rr / curvature;
+        if ((p + alpha * d).norm() >= m_radius) {
+            double tau = toBoundary(p, d, m_radius);
+            p += tau * d;
+            Hp += tau * Hd;
+            return true;
+        }
+        p += alpha * d;
+        Hp += alpha * Hd;
+        r += alpha * Hd;
+        double rrNew = r.squaredNorm();
+        if (std::sqrt(rrNew) < tolerance) break;
+        d = -r + (rrNew / rr) * d;
+        rr = rrNew;
+    }
+    return false;
+}
+
+void TrustRegionNewton::_run(){
+    const size_t n = m_problem.dimension();
+    Eigen::VectorXd gradient(n), p(n), Hp(n), xNew(n);
+    double value = m_problem.value(m_x.data());
+    m_problem.gradient(m_x.data(), gradient.data());
+
+    m_iterations = 0;
+    m_products = 0;
+    while (m_iterations < m_maxIterations && gradient.norm() > m_tolerance && m_radius > 1e-14) {
+        bool boundary = steihaug(gradient, p, Hp);
+        double predicted = -(gradient.dot(p) + 0.5 * p.dot(Hp));
+        xNew = m_x + p;
+        double valueNew = m_problem.value(xNew.data());
+        double rho = predicted > 0 ? (value - valueNew) / predicted : -1.0;
+
+        // Shrink when the model was poor, grow when it was good and the step was limited by the region
+        if (rho < 0.25) m_radius = 0.25 * p.norm();
+        else if (rho > 0.75 && boundary) m_radius = std::min(2 * m_radius, m_maxRadius);
+
+        if (rho > 0.1) {
+            m_x.swap(xNew);
+            value = valueNew;
+            m_problem.gradient(m_x.data(), gradient.data());
+        }
+        ++m_iterations;
+    }
+    std::cout<< "The trust-region Newton-CG found the minimum in "<< m_iterations <<" steps at "<<m_problem.describe(m_x)<< "\n";
+}
+
+const Eigen::VectorXd& TrustRegionNewton::solution() const {
+    return m_x;
+}
+
+size_t TrustRegionNewton::iterations() const {
+    return m_iterations;
+}
+
+size_t TrustRegionNewton::hessianVectorProducts() const {
+    return m_products;
+}
+
+double TrustRegionNewton::radius() const {
+    return m_radius;
+}
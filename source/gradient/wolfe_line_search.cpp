@@ -0,0 +1,67 @@
+#include "../../include/gradient/wolfe_line_search.hpp"
+#include <cmath>
+#include <stdexcept>
+
+// Minimizer of the cubic through (a, fa, ga) and (b, fb, gb), NaN if it has none
+static double cubicMinimizer(double a, double fa, double ga, double b, double fb, double gb) {
+    double d1 = ga + gb - 3 * (fa - fb) / (a - b);
+    double radicand = d1 * d1 - ga * gb;
+    if (radicand < 0) return NAN;
+    double d2 = std::copysign(std::sqrt(radicand), b - a);
+    return b - (b - a) * (gb + d2 - d1) / (gb - ga + 2 * d2);
+}
+
+WolfeLineSearch::WolfeLineSearch(double c1, double c2, size_t maxEvaluations)
+: m_c1(c1)
+, m_c2(c2)
+, m_maxEvaluations(maxEvaluations)
+{
+    if (!(0 < c1 && c1 < c2 && c2 < 1)) throw std::invalid_argument("WolfeLineSearch: needs 0 < c1 < c2 < 1");
+}
+
+WolfeLineSearch::Trial WolfeLineSearch::evaluate(LineRestriction& line, double step) const {
+    return {step, line.value(step), line.derivative(step)};
+}
+
+LineSearch::Result WolfeLineSearch::search(LineRestriction& line, double value, double slope, double initialStep) const {
+    if (slope >= 0) throw std::invalid_argument("WolfeLineSearch: not a descent direction");
+    Trial previous{0.0, value, slope};
+    double step = initialStep;
+    for (size_t evaluations = 1; ; ++evaluations) {
+        Trial trial = evaluate(line, step);
+        if (trial.value > value + m_c1 * step * slope || (evaluations > 1 && trial.value >= previous.value)) {
+            return zoom(line, previous, trial, value, slope, evaluations);
+        }
+        if (std::fabs(trial.slope) <= -m_c2 * slope) return {trial.step, trial.value, trial.slope, evaluations, true, true};
+        if (trial.slope >= 0) return zoom(line, trial, previous, value, slope, evaluations);
+        if (evaluations >= m_maxEvaluations) return {trial.step, trial.value, trial.slope, evaluations, false, true};
+        previous = trial;
+        step *= 2;
+    }
+}
+
+// low has the lowest value so far and satisfies sufficient decrease, the minimizer lies between low and high
+LineSearch::Result WolfeLineSearch::zoom(LineRestriction& line, Trial low, Trial high, double value, double slope, size_t evaluations) const {
+    while (evaluations < m_maxEvaluations) {
+        double left = std::fmin(low.step, high.step), right = std::fmax(low.step, high.step);
+        double margin = 0.1 * (right - left);
+        double step = cubicMinimizer(low.step, low.value, low.slope, high.step, high.value, high.slope);
+        // Safeguard: stay clear of the ends of the bracket, bisect when the cubic is no help
+        if (!std::isfinite(step) || step < left + margin || step > right - margin) step = (left + right) / 2;
+
+        Trial trial = evaluate(line, step);
+        ++evaluations;
+        if (trial.value > value + m_c1 * step * slope || trial.value >= low.value) {
+            high = trial;
+        } else {
+            if (std::fabs(trial.slope) <= -m_c2 * slope) return {trial.step, trial.value, trial.slope, evaluations, true, true};
+            if (trial.slope * (high.step - low.step) >= 0) high = low;
+            low = trial;
+        }
+        if (right - left < 1e-16 * std::fmax(1.0, right)) break;
+    }
+    // Out of evaluations: settle for low, whose gradient the line may no longer hold
+    if (low.step == 0.0) return {0.0, value, slope, evaluations, false, false};
+    Trial best = evaluate(line, low.step);
+    return {best.step, best.value, best.slope, evaluations + 1, false, true};
+}
@@ -59,18 +59,64 @@ int main() {
     std::cout << "expression value for x1 = " << xValue << " and x2 = " << yValue<< " is: " << result << "\n";
     std::cout << "1st order differential value for x1 = " << xValue << " and x2 = " << yValue << " is: " << result_diff << "\n";
 
-    Newton newton(root, x0);
+    // Groups of variables that never appear in the same term can be minimized separately
+    Separability::Decomposition decomposition = Separability::decompose(root);
+    std::cout << "Independent subproblems: " << decomposition.components.size() << "\n";
+
+    // Differentiate and compile the objective and gradient once for all the solvers,
+    // Newton derives the Hessian entries it needs on demand
+    PreparedProblem problem(root, x0);
+
+    Newton newton(problem, x0);
     std::cout << "\nNewton: " << "\n";
     newton._run();
 
     // STEEPEST DESCENT
-    Steepest_Descent steepest_descent(root, expression, 0.001, 0, 10, x0);
+    Steepest_Descent steepest_descent(problem, 0.001, 0, 10, x0);
     std::cout << "Steepest Descent: " << "\n";
     steepest_descent._run();
 
     // CONJUGATE GRADIENT
-    Conjugate_Gradient conjugate_gradient(root, expression, x0, 0.001);
+    Conjugate_Gradient conjugate_gradient(problem, x0, 0.001);
     std::cout << "Conjugate Gradient: " << "\n";
     conjugate_gradient._run();
+
+    // L-BFGS
+    LBFGS lbfgs(problem, x0);
+    std::cout << "L-BFGS: " << "\n";
+    lbfgs._run();
+
+    // BFGS
+    BFGS bfgs(problem, x0);
+    std::cout << "BFGS: " << "\n";
+    bfgs._run();
+
+    // TRUST-REGION NEWTON-CG, Hessian-vector products only
+    TrustRegionNewton trust_region(problem, x0);
+    std::cout << "Trust-region Newton-CG: " << "\n";
+    trust_region._run();
+
+    // SPARSE NEWTON, element-wise Hessian and sparse LDLT
+    SparseNewton sparse_newton(problem, x0);
+    std::cout << "Sparse Newton: " << "\n";
+    sparse_newton._run();
+
+    // INDEPENDENT SUBPROBLEMS, L-BFGS on each component concurrently
+    ThreadPool pool;
+    if (decomposition.components.size() > 1) {
+        DecomposedSolver decomposed(root, pool);
+        std::cout << "Decomposed L-BFGS: " << "\n";
+        DecomposedSolver::Point minimizer = decomposed.solve(x0, [](const PreparedProblem& component, const DecomposedSolver::Point& start) {
+            LBFGS lbfgs(component, start);
+            lbfgs._run();
+            return component.toMap(lbfgs.solution());
+        });
+        std::cout << "The decomposed L-BFGS found the minimum at " << problem.describe(problem.toEigen(minimizer)) << "\n";
+    }
+
+    // NELDER-MEAD, objective values only, the trial points of an iteration evaluated concurrently
+    NelderMead nelder_mead(root, x0, pool);
+    std::cout << "Nelder-Mead: " << "\n";
+    nelder_mead._run();
     return 0;
 }
@@ -0,0 +1,41 @@
+#include "../../include/numerical/decomposed_solver.hpp"
+#include <chrono>
+
+DecomposedSolver::DecomposedSolver(Node* function, ThreadPool& pool, bool withHessian)
+: m_pool(pool)
+, m_decomposition(Separability::decompose(function))
+{
+    for (const Separability::Component& component : m_decomposition.components) {
+        m_problems.push_back(std::make_unique<PreparedProblem>(component.function, component.variables, withHessian));
+    }
+    m_componentSeconds.assign(m_problems.size(), 0.0);
+}
+
+DecomposedSolver::Point DecomposedSolver::solve(const Point& x0, const Solve& routine) {
+    std::vector<Point> minimizers(m_problems.size());
+    m_pool.run(m_problems.size(), [&](size_t c, size_t) {
+        auto start = std::chrono::steady_clock::now();
+        Point startPoint;
+        for (const std::string& name : m_problems[c]->variables()) startPoint[name] = x0.at(name);
+        minimizers[c] = routine(*m_problems[c], startPoint);
+        m_componentSeconds[c] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    });
+
+    Point result = x0;
+    for (const Point& minimizer : minimizers) {
+        for (const auto& [name, value] : minimizer) result[name] = value;
+    }
+    return result;
+}
+
+const Separability::Decomposition& DecomposedSolver::decomposition() const {
+    return m_decomposition;
+}
+
+size_t DecomposedSolver::components() const {
+    return m_problems.size();
+}
+
+const std::vector<double>& DecomposedSolver::componentSeconds() const {
+    return m_componentSeconds;
+}
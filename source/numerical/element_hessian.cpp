@@ -0,0 +1,99 @@
+#include "../../include/numerical/element_hessian.hpp"
+#include "../../include/syntax_tree/differentiator.hpp"
+#include "../../include/syntax_tree/separability.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Position of (row, col) in the value array of a compressed column major matrix
+static int position(const Eigen::SparseMatrix<double>& matrix, int row, int col) {
+    const int* begin = matrix.innerIndexPtr() + matrix.outerIndexPtr()[col];
+    const int* end = matrix.innerIndexPtr() + matrix.outerIndexPtr()[col + 1];
+    return std::lower_bound(begin, end, row) - matrix.innerIndexPtr();
+}
+
+ElementHessian::ElementHessian(Node* function, const std::vector<std::string>& variables, Storage storage)
+: m_storage(storage)
+, m_pattern(variables.size(), variables.size())
+, m_elements(0)
+{
+    // Element entries: the upper triangle of every term's own Hessian, zeros that simplify away left out
+    struct Entry { int row, col; double sign; };
+    Differentiator differentiator;
+    std::vector<Node*> roots;
+    std::vector<Entry> entries;
+    for (const auto& [term, negative] : Separability::terms(function)) {
+        std::vector<int> indices;
+        std::vector<std::string> names = Separability::variables(term);
+        for (const std::string& name : names) {
+            auto found = std::find(variables.begin(), variables.end(), name);
+            if (found == variables.end()) throw std::invalid_argument("ElementHessian: unknown variable " + name);
+            indices.push_back(found - variables.begin());
+        }
+        if (indices.empty()) continue;
+        ++m_elements;
+        for (size_t a = 0; a < names.size(); ++a) {
+            Node* first = differentiator.partialDerivative(term, names[a]);
+            if (!first) throw std::invalid_argument("ElementHessian: cannot differentiate a term");
+            for (size_t b = a; b < names.size(); ++b) {
+                Node* second = differentiator.partialDerivative(first, names[b]);
+                if (!second) throw std::invalid_argument("ElementHessian: cannot differentiate a term");
+                if (second->data.type == Token::NUMBER && std::stod(second->data.value) == 0.0) continue;
+                roots.push_back(second);
+                entries.push_back({std::max(indices[a], indices[b]), std::min(indices[a], indices[b]), negative ? -1.0 : 1.0});
+            }
+        }
+    }
+
+    // Pattern: the union of the element blocks, built once
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (const Entry& entry : entries) {
+        triplets.emplace_back(entry.row, entry.col, 0.0);
+        if (storage == FULL && entry.row != entry.col) triplets.emplace_back(entry.col, entry.row, 0.0);
+    }
+    m_pattern.setFromTriplets(triplets.begin(), triplets.end());
+    m_pattern.makeCompressed();
+
+    // Where every element entry lands in the value array
+    m_targetStart.push_back(0);
+    for (const Entry& entry : entries) {
+        m_targets.push_back(position(m_pattern, entry.row, entry.col));
+        if (storage == FULL && entry.row != entry.col) m_targets.push_back(position(m_pattern, entry.col, entry.row));
+        m_targetStart.push_back(m_targets.size());
+        m_signs.push_back(entry.sign);
+    }
+    if (!roots.empty()) m_program = Program(roots, variables);
+    m_results.resize(roots.size());
+}
+
+void ElementHessian::assemble(const double* x, Eigen::SparseMatrix<double>& hessian) const {
+    bool samePattern = hessian.isCompressed() && hessian.rows() == m_pattern.rows() && hessian.cols() == m_pattern.cols()
+        && hessian.nonZeros() == m_pattern.nonZeros()
+        && std::equal(m_pattern.outerIndexPtr(), m_pattern.outerIndexPtr() + m_pattern.outerSize() + 1, hessian.outerIndexPtr())
+        && std::equal(m_pattern.innerIndexPtr(), m_pattern.innerIndexPtr() + m_pattern.nonZeros(), hessian.innerIndexPtr());
+    if (!samePattern) hessian = m_pattern;
+    double* values = hessian.valuePtr();
+    std::fill(values, values + hessian.nonZeros(), 0.0);
+    if (m_results.empty()) return;
+
+    m_program.evaluate(x, m_values, m_results.data());
+    for (size_t e = 0; e < m_results.size(); ++e) {
+        double value = m_signs[e] * m_results[e];
+        for (int t = m_targetStart[e]; t < m_targetStart[e + 1]; ++t) values[m_targets[t]] += value;
+    }
+}
+
+const Eigen::SparseMatrix<double>& ElementHessian::pattern() const {
+    return m_pattern;
+}
+
+size_t ElementHessian::elements() const {
+    return m_elements;
+}
+
+size_t ElementHessian::elementEntries() const {
+    return m_results.size();
+}
+
+size_t ElementHessian::nonZeros() const {
+    return m_pattern.nonZeros();
+}
@@ -0,0 +1,130 @@
+#include "../../include/numerical/evaluation_context.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+EvaluationContext::EvaluationContext(const PreparedProblem& problem)
+: m_x(problem.dimension(), 0.0)
+, m_epoch(0)
+, m_computed(0)
+, m_hasPoint(false)
+{
+    const size_t n = problem.dimension();
+    std::vector<Node*> roots{problem.function()};
+    for (size_t i = 0; i < n; ++i) roots.push_back(problem.gradientNode(i));
+    if (problem.hasHessian()) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) roots.push_back(problem.hessianNode(i, j));
+        }
+    }
+    m_program = Program(roots, problem.variables());
+    m_values.assign(m_program.size(), 0.0);
+
+    // Slots each part depends on: mark its outputs, then walk the program backwards
+    const std::vector<Program::Instruction>& code = m_program.instructions();
+    const std::vector<int>& outputs = m_program.outputs();
+    std::vector<std::pair<size_t, size_t>> ranges{{0, 1}, {1, 1 + n}};
+    if (problem.hasHessian()) ranges.push_back({1 + n, 1 + n + n * n});
+    for (const auto& [begin, end] : ranges) {
+        std::vector<char> needed(code.size(), 0);
+        for (size_t k = begin; k < end; ++k) needed[outputs[k]] = 1;
+        for (size_t slot = code.size(); slot-- > 0;) {
+            if (!needed[slot] || code[slot].op == Program::CONSTANT || code[slot].op == Program::VARIABLE) continue;
+            needed[code[slot].lhs] = 1;
+            if (code[slot].rhs >= 0) needed[code[slot].rhs] = 1;
+        }
+        std::vector<int> slots;
+        for (size_t slot = 0; slot < code.size(); ++slot) {
+            if (needed[slot]) slots.push_back(static_cast<int>(slot));
+        }
+        m_needs.push_back(slots);
+    }
+    m_plans.assign(m_needs.size(), std::vector<std::vector<int>>(1u << m_needs.size()));
+    m_planned.assign(m_needs.size(), std::vector<char>(1u << m_needs.size(), 0));
+}
+
+void EvaluationContext::setPoint(const double* x) {
+    if (m_hasPoint && std::equal(m_x.begin(), m_x.end(), x)) return;
+    std::copy(x, x + m_x.size(), m_x.begin());
+    m_hasPoint = true;
+    invalidate();
+}
+
+void EvaluationContext::invalidate() {
+    ++m_epoch;
+    m_computed = 0;
+}
+
+const std::vector<int>& EvaluationContext::plan(Part part) {
+    if (!m_planned[part][m_computed]) {
+        // Slots of part that none of the computed parts has produced
+        std::vector<char> done(m_program.size(), 0);
+        for (size_t other = 0; other < m_needs.size(); ++other) {
+            if (m_computed & (1u << other)) {
+                for (int slot : m_needs[other]) done[slot] = 1;
+            }
+        }
+        for (int slot : m_needs[part]) {
+            if (!done[slot]) m_plans[part][m_computed].push_back(slot);
+        }
+        m_planned[part][m_computed] = 1;
+    }
+    return m_plans[part][m_computed];
+}
+
+void EvaluationContext::compute(Part part) {
+    if (!m_hasPoint) throw std::logic_error("EvaluationContext: no point set");
+    if (part >= static_cast<int>(m_needs.size())) throw std::logic_error("EvaluationContext: problem prepared without its Hessian");
+    if (m_computed & (1u << part)) {
+        m_statistics.reused += m_needs[part].size();
+        return;
+    }
+    const std::vector<int>& slots = plan(part);
+    const std::vector<Program::Instruction>& code = m_program.instructions();
+    for (int slot : slots) {
+        m_values[slot] = Program::compute(code[slot], m_x.data(), m_values.data());
+    }
+    m_statistics.computed += slots.size();
+    m_statistics.reused += m_needs[part].size() - slots.size();
+    m_computed |= 1u << part;
+}
+
+double EvaluationContext::value() {
+    compute(VALUE);
+    return m_values[m_program.outputs()[0]];
+}
+
+void EvaluationContext::gradient(double* g) {
+    compute(GRADIENT);
+    const std::vector<int>& outputs = m_program.outputs();
+    for (size_t i = 0; i < m_x.size(); ++i) g[i] = m_values[outputs[1 + i]];
+}
+
+void EvaluationContext::hessian(double* h) {
+    compute(HESSIAN);
+    const std::vector<int>& outputs = m_program.outputs();
+    const size_t n = m_x.size();
+    for (size_t k = 0; k < n * n; ++k) h[k] = m_values[outputs[1 + n + k]];
+}
+
+double EvaluationContext::value(const double* x) {
+    setPoint(x);
+    return value();
+}
+
+void EvaluationContext::gradient(const double* x, double* g) {
+    setPoint(x);
+    gradient(g);
+}
+
+void EvaluationContext::hessian(const double* x, double* h) {
+    setPoint(x);
+    hessian(h);
+}
+
+size_t EvaluationContext::epoch() const {
+    return m_epoch;
+}
+
+const EvaluationContext::Statistics& EvaluationContext::statistics() const {
+    return m_statistics;
+}
@@ -0,0 +1,67 @@
+#include "../../include/numerical/hessian_assembler.hpp"
+#include <algorithm>
+#include <chrono>
+
+HessianAssembler::HessianAssembler(const PreparedProblem& problem, ThreadPool& pool)
+: m_problem(problem)
+, m_pool(pool)
+, m_values(pool.size())
+, m_results(pool.size())
+{
+    auto start = std::chrono::steady_clock::now();
+    const size_t n = problem.dimension();
+
+    // Rows shrink towards the end, so the blocks are balanced by entries rather than rows
+    const size_t total = n * (n + 1) / 2;
+    const size_t blocks = std::max<size_t>(1, std::min(n, pool.size() * BLOCKS_PER_WORKER));
+    const size_t target = (total + blocks - 1) / blocks;
+
+    // Differentiation is not thread safe, the entries are derived up front
+    LazyHessian entries(problem);
+    size_t first = 0;
+    while (first < n) {
+        size_t last = first, count = 0;
+        std::vector<Node*> roots;
+        while (last < n && (count < target || last == first)) {
+            for (size_t j = last; j < n; ++j) roots.push_back(entries.entryNode(last, j));
+            count += n - last;
+            ++last;
+        }
+        m_blocks.push_back({first, last, Program(roots, problem.variables())});
+        first = last;
+    }
+
+    m_timing.preparationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_timing.entries = n * (n + 1) / 2;
+    m_timing.workers = pool.size();
+}
+
+void HessianAssembler::assemble(const double* x, Eigen::MatrixXd& hessian, Storage storage) {
+    auto start = std::chrono::steady_clock::now();
+    const size_t n = m_problem.dimension();
+    if (hessian.rows() != static_cast<Eigen::Index>(n) || hessian.cols() != static_cast<Eigen::Index>(n)) hessian.resize(n, n);
+
+    // Tasks touch disjoint entries: (i, j >= i) and (j >= i, i) only belong to the block of row i
+    m_pool.run(m_blocks.size(), [&](size_t task, size_t worker) {
+        const RowBlock& block = m_blocks[task];
+        std::vector<double>& results = m_results[worker];
+        results.resize(block.program.outputs().size());
+        block.program.evaluate(x, m_values[worker], results.data());
+
+        const double* entry = results.data();
+        for (size_t i = block.first; i < block.last; ++i) {
+            double* column = hessian.data() + i * n;
+            for (size_t j = i; j < n; ++j) column[j] = entry[j - i];
+            if (storage == FULL) {
+                for (size_t j = i + 1; j < n; ++j) hessian(i, j) = entry[j - i];
+            }
+            entry += n - i;
+        }
+    });
+
+    m_timing.assemblySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+const HessianAssembler::Timing& HessianAssembler::timing() const {
+    return m_timing;
+}
@@ -0,0 +1,192 @@
+#include "../../include/numerical/incremental_evaluator.hpp"
+#include <algorithm>
+#include <cmath>
+
+IncrementalEvaluator::IncrementalEvaluator(const Program& program)
+: m_program(program)
+, m_x(program.variables().size(), 0.0)
+, m_values(program.size(), 0.0)
+, m_outputs(program.outputs().size(), 0.0)
+, m_dependents(program.variables().size())
+, m_terms(program.outputs().size())
+, m_dirtyVariable(program.variables().size(), 0)
+, m_staleOutput(program.outputs().size(), 0)
+, m_recomputed(0)
+, m_updatesSinceRefresh(0)
+{
+    const std::vector<Program::Instruction>& code = program.instructions();
+    const int count = static_cast<int>(code.size());
+    auto operands = [&code](int slot) {
+        const Program::Instruction& instruction = code[slot];
+        if (instruction.op == Program::CONSTANT || instruction.op == Program::VARIABLE) return std::make_pair(-1, -1);
+        return std::make_pair(instruction.lhs, instruction.rhs);
+    };
+
+    std::vector<int> uses(count, 0);
+    for (int slot = 0; slot < count; ++slot) {
+        auto [lhs, rhs] = operands(slot);
+        if (lhs >= 0) uses[lhs]++;
+        if (rhs >= 0) uses[rhs]++;
+    }
+
+    std::vector<char> isOutput(count, 0);
+    for (int root : program.outputs()) isOutput[root] = 1;
+
+    // Flatten the top-level sum of every output that nothing else reads. The chain stops at a
+    // sum that is itself an output (e.g. a+b in (a+b)+c after CSE): that output keeps its value
+    // in the slot, so the slot has to be recomputed rather than only accumulated.
+    std::vector<char> accumulated(count, 0);
+    for (size_t k = 0; k < program.outputs().size(); ++k) {
+        int root = program.outputs()[k];
+        auto isSum = [&code](int slot) { return code[slot].op == Program::ADD || code[slot].op == Program::SUB; };
+        if (!isSum(root) || uses[root] > 0) {
+            m_terms[k].push_back({root, 1.0});
+            continue;
+        }
+        std::vector<std::pair<int, double>> stack{{root, 1.0}};
+        while (!stack.empty()) {
+            auto [slot, sign] = stack.back();
+            stack.pop_back();
+            if (isSum(slot) && (slot == root || (uses[slot] == 1 && !isOutput[slot]))) {
+                accumulated[slot] = 1;
+                stack.push_back({code[slot].rhs, code[slot].op == Program::SUB ? -sign : sign});
+                stack.push_back({code[slot].lhs, sign});
+            } else {
+                m_terms[k].push_back({slot, sign});
+            }
+        }
+    }
+
+    std::vector<std::vector<std::pair<int, double>>> owners(count);
+    for (size_t k = 0; k < m_terms.size(); ++k) {
+        for (const auto& [slot, sign] : m_terms[k]) owners[slot].push_back({static_cast<int>(k), sign});
+    }
+    m_termStart.assign(count + 1, 0);
+    for (int slot = 0; slot < count; ++slot) {
+        m_termStart[slot + 1] = m_termStart[slot] + static_cast<int>(owners[slot].size());
+        m_termOwners.insert(m_termOwners.end(), owners[slot].begin(), owners[slot].end());
+    }
+
+    // Users of every slot, the accumulated sums are kept up to date through the terms instead
+    std::vector<std::vector<int>> users(count);
+    for (int slot = 0; slot < count; ++slot) {
+        if (accumulated[slot]) continue;
+        auto [lhs, rhs] = operands(slot);
+        if (lhs >= 0) users[lhs].push_back(slot);
+        if (rhs >= 0 && rhs != lhs) users[rhs].push_back(slot);
+    }
+
+    // Slots reachable from every variable, in program order
+    std::vector<int> visited(count, -1);
+    for (int slot = 0; slot < count; ++slot) {
+        if (code[slot].op != Program::VARIABLE) continue;
+        int variable = code[slot].lhs;
+        std::vector<int>& reached = m_dependents[variable];
+        std::vector<int> stack{slot};
+        visited[slot] = variable;
+        while (!stack.empty()) {
+            int current = stack.back();
+            stack.pop_back();
+            reached.push_back(current);
+            for (int user : users[current]) {
+                if (visited[user] != variable) {
+                    visited[user] = variable;
+                    stack.push_back(user);
+                }
+            }
+        }
+        std::sort(reached.begin(), reached.end());
+    }
+}
+
+void IncrementalEvaluator::sumOutput(size_t k) {
+    double sum = 0.0;
+    for (const auto& [slot, sign] : m_terms[k]) sum += sign * m_values[slot];
+    m_outputs[k] = sum;
+}
+
+void IncrementalEvaluator::sumOutputs() {
+    for (size_t k = 0; k < m_terms.size(); ++k) sumOutput(k);
+    m_updatesSinceRefresh = 0;
+}
+
+void IncrementalEvaluator::bind(const double* x) {
+    std::copy(x, x + m_x.size(), m_x.begin());
+    m_program.run(m_x.data(), m_values.data());
+    sumOutputs();
+    for (size_t variable : m_dirty) m_dirtyVariable[variable] = 0;
+    m_dirty.clear();
+    m_recomputed = m_values.size();
+}
+
+void IncrementalEvaluator::set(size_t variable, double value) {
+    if (m_x[variable] == value) return;
+    m_x[variable] = value;
+    if (!m_dirtyVariable[variable]) {
+        m_dirtyVariable[variable] = 1;
+        m_dirty.push_back(variable);
+    }
+}
+
+double IncrementalEvaluator::evaluate() {
+    if (m_dirty.empty()) {
+        m_recomputed = 0;
+        return m_outputs.empty() ? 0.0 : m_outputs[0];
+    }
+
+    // One dirty variable uses its list as is, several are merged into one ordered list
+    const std::vector<int>* slots = &m_dependents[m_dirty[0]];
+    if (m_dirty.size() > 1) {
+        m_merged.clear();
+        for (size_t variable : m_dirty) {
+            m_merged.insert(m_merged.end(), m_dependents[variable].begin(), m_dependents[variable].end());
+        }
+        std::sort(m_merged.begin(), m_merged.end());
+        m_merged.erase(std::unique(m_merged.begin(), m_merged.end()), m_merged.end());
+        slots = &m_merged;
+    }
+
+    const std::vector<Program::Instruction>& code = m_program.instructions();
+    for (int slot : *slots) {
+        double previous = m_values[slot];
+        m_values[slot] = Program::compute(code[slot], m_x.data(), m_values.data());
+        double change = m_values[slot] - previous;
+        // inf - inf would leave the sum NaN for good, and so would a NaN term once it is gone
+        bool finite = std::isfinite(previous) && std::isfinite(m_values[slot]);
+        for (int owner = m_termStart[slot]; owner < m_termStart[slot + 1]; ++owner) {
+            int k = m_termOwners[owner].first;
+            if (m_staleOutput[k]) continue;
+            if (finite) m_outputs[k] += m_termOwners[owner].second * change;
+            if (!finite || std::fabs(change) > CANCELLATION * std::fabs(m_outputs[k])) {
+                m_staleOutput[k] = 1;
+                m_stale.push_back(k);
+            }
+        }
+    }
+    m_recomputed = slots->size();
+    // Every term is up to date now
+    for (size_t k : m_stale) {
+        sumOutput(k);
+        m_staleOutput[k] = 0;
+    }
+    m_stale.clear();
+
+    for (size_t variable : m_dirty) m_dirtyVariable[variable] = 0;
+    m_dirty.clear();
+
+    // Adding up differences accumulates rounding errors, so start over from time to time
+    if (++m_updatesSinceRefresh >= REFRESH_INTERVAL) sumOutputs();
+    return m_outputs.empty() ? 0.0 : m_outputs[0];
+}
+
+double IncrementalEvaluator::output(size_t k) const {
+    return m_outputs[k];
+}
+
+const std::vector<double>& IncrementalEvaluator::point() const {
+    return m_x;
+}
+
+size_t IncrementalEvaluator::recomputed() const {
+    return m_recomputed;
+}
@@ -0,0 +1,104 @@
+#include "../../include/numerical/lazy_hessian.hpp"
+#include <numeric>
+#include <stdexcept>
+
+LazyHessian::LazyHessian(const PreparedProblem& problem)
+: m_problem(problem)
+, m_hasDiagonal(false)
+{
+}
+
+void LazyHessian::check(size_t i) const {
+    if (i >= m_problem.dimension()) throw std::invalid_argument("LazyHessian: index out of range");
+}
+
+Node* LazyHessian::entryNode(size_t i, size_t j) {
+    check(i);
+    check(j);
+    if (i > j) std::swap(i, j);
+    auto it = m_entries.find({i, j});
+    if (it != m_entries.end()) return it->second;
+    Node* entry = m_differentiator.partialDerivative(m_problem.gradientNode(i), m_problem.variables()[j]);
+    m_entries.emplace(std::make_pair(i, j), entry);
+    return entry;
+}
+
+double LazyHessian::entry(const double* x, size_t i, size_t j) {
+    if (i > j) std::swap(i, j);
+    auto it = m_entryPrograms.find({i, j});
+    if (it == m_entryPrograms.end()) {
+        it = m_entryPrograms.emplace(std::make_pair(i, j), Program(entryNode(i, j), m_problem.variables())).first;
+    }
+    return it->second.evaluate(x, m_values);
+}
+
+void LazyHessian::row(const double* x, size_t i, double* row) {
+    check(i);
+    auto it = m_rowPrograms.find(i);
+    if (it == m_rowPrograms.end()) {
+        std::vector<Node*> entries;
+        for (size_t j = 0; j < m_problem.dimension(); ++j) entries.push_back(entryNode(i, j));
+        it = m_rowPrograms.emplace(i, Program(entries, m_problem.variables())).first;
+    }
+    it->second.evaluate(x, m_values, row);
+}
+
+void LazyHessian::diagonal(const double* x, double* diagonal) {
+    if (!m_hasDiagonal) {
+        std::vector<Node*> entries;
+        for (size_t i = 0; i < m_problem.dimension(); ++i) entries.push_back(entryNode(i, i));
+        m_diagonalProgram = Program(entries, m_problem.variables());
+        m_hasDiagonal = true;
+    }
+    m_diagonalProgram.evaluate(x, m_values, diagonal);
+}
+
+void LazyHessian::block(const double* x, const std::vector<size_t>& indices, double* block) {
+    const size_t size = indices.size();
+    auto it = m_blockPrograms.find(indices);
+    if (it == m_blockPrograms.end()) {
+        std::vector<Node*> entries;
+        for (size_t a = 0; a < size; ++a) {
+            for (size_t b = a; b < size; ++b) entries.push_back(entryNode(indices[a], indices[b]));
+        }
+        it = m_blockPrograms.emplace(indices, Program(entries, m_problem.variables())).first;
+    }
+    m_results.resize(size * (size + 1) / 2);
+    it->second.evaluate(x, m_values, m_results.data());
+
+    // Mirror the upper triangle
+    size_t k = 0;
+    for (size_t a = 0; a < size; ++a) {
+        for (size_t b = a; b < size; ++b, ++k) {
+            block[a * size + b] = m_results[k];
+            block[b * size + a] = m_results[k];
+        }
+    }
+}
+
+std::vector<Eigen::MatrixXd> LazyHessian::blockDiagonal(const double* x, const std::vector<std::vector<size_t>>& blocks) {
+    std::vector<Eigen::MatrixXd> result;
+    for (const std::vector<size_t>& indices : blocks) {
+        // Symmetric, so the row major output is also the column major matrix
+        Eigen::MatrixXd matrix(indices.size(), indices.size());
+        block(x, indices, matrix.data());
+        result.push_back(matrix);
+    }
+    return result;
+}
+
+Eigen::MatrixXd LazyHessian::full(const double* x) {
+    std::vector<size_t> indices(m_problem.dimension());
+    std::iota(indices.begin(), indices.end(), 0);
+    Eigen::MatrixXd matrix(indices.size(), indices.size());
+    block(x, indices, matrix.data());
+    return matrix;
+}
+
+size_t LazyHessian::derivedEntries() const {
+    return m_entries.size();
+}
+
+size_t LazyHessian::compiledPrograms() const {
+    return m_entryPrograms.size() + m_rowPrograms.size() + m_blockPrograms.size() + (m_hasDiagonal ? 1 : 0);
+}
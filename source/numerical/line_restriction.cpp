@@ -0,0 +1,77 @@
+#include "../../include/numerical/line_restriction.hpp"
+#include <algorithm>
+
+LineRestriction::LineRestriction(const PreparedProblem& problem)
+: m_problem(problem)
+, m_x(problem.dimension(), 0.0)
+, m_d(problem.dimension(), 0.0)
+, m_objective{&problem.objectiveProgram(), {}, {}}
+, m_gradient{&problem.gradientProgram(), {}, {}}
+, m_evaluations(0)
+{
+}
+
+void LineRestriction::Restricted::setLine(const double* x, const double* d) {
+    const std::vector<Program::Instruction>& code = program->instructions();
+    values.resize(code.size());
+    moving.clear();
+    std::vector<char> depends(code.size(), 0);
+    for (size_t slot = 0; slot < code.size(); ++slot) {
+        const Program::Instruction& instruction = code[slot];
+        if (instruction.op == Program::CONSTANT) {
+            depends[slot] = 0;
+        } else if (instruction.op == Program::VARIABLE) {
+            depends[slot] = d[instruction.lhs] != 0.0;
+        } else {
+            depends[slot] = depends[instruction.lhs] || (instruction.rhs >= 0 && depends[instruction.rhs]);
+        }
+        if (depends[slot]) moving.push_back(static_cast<int>(slot));
+        // Hoisted: evaluated here once for the whole line search
+        else values[slot] = Program::compute(instruction, x, values.data());
+    }
+}
+
+void LineRestriction::Restricted::run(double s, const double* x, const double* d) {
+    const std::vector<Program::Instruction>& code = program->instructions();
+    for (int slot : moving) {
+        const Program::Instruction& instruction = code[slot];
+        if (instruction.op == Program::VARIABLE) values[slot] = x[instruction.lhs] + s * d[instruction.lhs];
+        else values[slot] = Program::compute(instruction, nullptr, values.data());
+    }
+}
+
+void LineRestriction::setLine(const double* x, const double* d) {
+    std::copy(x, x + m_x.size(), m_x.begin());
+    std::copy(d, d + m_d.size(), m_d.begin());
+    m_objective.setLine(x, d);
+    m_gradient.setLine(x, d);
+    m_evaluations = 0;
+}
+
+double LineRestriction::value(double s) {
+    m_objective.run(s, m_x.data(), m_d.data());
+    ++m_evaluations;
+    return m_objective.values[m_objective.program->outputs()[0]];
+}
+
+double LineRestriction::derivative(double s) {
+    m_gradient.run(s, m_x.data(), m_d.data());
+    ++m_evaluations;
+    const std::vector<int>& outputs = m_gradient.program->outputs();
+    double slope = 0.0;
+    for (size_t i = 0; i < outputs.size(); ++i) slope += m_gradient.values[outputs[i]] * m_d[i];
+    return slope;
+}
+
+void LineRestriction::gradient(double* g) const {
+    const std::vector<int>& outputs = m_gradient.program->outputs();
+    for (size_t i = 0; i < outputs.size(); ++i) g[i] = m_gradient.values[outputs[i]];
+}
+
+void LineRestriction::point(double s, double* point) const {
+    for (size_t i = 0; i < m_x.size(); ++i) point[i] = m_x[i] + s * m_d[i];
+}
+
+size_t LineRestriction::evaluations() const {
+    return m_evaluations;
+}
@@ -0,0 +1,115 @@
+#include "../../include/numerical/parallel_evaluator.hpp"
+#include "../../include/syntax_tree/differentiator.hpp"
+#include "../../include/syntax_tree/separability.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+
+size_t ParallelEvaluator::nodeCount(Node* root) {
+    std::unordered_set<Node*> visited;
+    std::vector<Node*> stack{root};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (!node || !visited.insert(node).second) continue;
+        stack.push_back(node->left);
+        stack.push_back(node->right);
+    }
+    return visited.size();
+}
+
+ParallelEvaluator::ParallelEvaluator(Node* function, const std::vector<std::string>& variables, ThreadPool& pool, bool withDerivatives)
+: m_variables(variables)
+, m_pool(pool)
+, m_withDerivatives(withDerivatives)
+, m_values(pool.size())
+, m_tangents(pool.size())
+{
+    std::vector<std::pair<Node*, bool>> terms = Separability::terms(function);
+    std::vector<size_t> costs;
+    size_t total = 0;
+    for (const auto& term : terms) {
+        costs.push_back(nodeCount(term.first));
+        total += costs.back();
+    }
+    const size_t target = std::max(size_t(MIN_CHUNK_NODES), total / (pool.size() * TASKS_PER_WORKER));
+
+    Differentiator differentiator;
+    size_t begin = 0;
+    while (begin < terms.size()) {
+        // Consecutive summands until the chunk reaches the target cost
+        size_t end = begin, cost = 0;
+        while (end < terms.size() && (cost < target || end == begin)) cost += costs[end++];
+
+        Chunk chunk;
+        chunk.objective = Program(Separability::sum({terms.begin() + begin, terms.begin() + end}), m_variables);
+        if (m_withDerivatives) {
+            // The gradient of a sum is the sum of the gradients of its summands, which are small
+            std::map<size_t, std::vector<std::pair<Node*, bool>>> partials;
+            for (size_t t = begin; t < end; ++t) {
+                for (const std::string& name : Separability::variables(terms[t].first)) {
+                    auto position = std::find(m_variables.begin(), m_variables.end(), name);
+                    if (position == m_variables.end()) throw std::invalid_argument("ParallelEvaluator: unknown variable " + name);
+                    Node* partial = differentiator.partialDerivative(terms[t].first, name);
+                    partials[position - m_variables.begin()].push_back({partial, terms[t].second});
+                }
+            }
+            std::vector<Node*> roots;
+            for (auto& [index, parts] : partials) {
+                chunk.variables.push_back(index);
+                roots.push_back(Separability::sum(parts));
+            }
+            chunk.gradient = Program(roots, m_variables);
+        }
+        m_chunks.push_back(std::move(chunk));
+        begin = end;
+    }
+
+    m_partialValues.resize(m_chunks.size());
+    m_partialVectors.resize(m_chunks.size());
+    for (size_t c = 0; c < m_chunks.size(); ++c) m_partialVectors[c].resize(m_chunks[c].variables.size());
+}
+
+double ParallelEvaluator::value(const double* x) {
+    m_pool.run(m_chunks.size(), [&](size_t task, size_t worker) {
+        m_partialValues[task] = m_chunks[task].objective.evaluate(x, m_values[worker]);
+    });
+    double sum = 0.0;
+    for (double partial : m_partialValues) sum += partial;
+    return sum;
+}
+
+void ParallelEvaluator::gradient(const double* x, double* g) {
+    if (!m_withDerivatives) throw std::logic_error("ParallelEvaluator: built without derivatives");
+    m_pool.run(m_chunks.size(), [&](size_t task, size_t worker) {
+        m_chunks[task].gradient.evaluate(x, m_values[worker], m_partialVectors[task].data());
+    });
+    mergeVectors(g);
+}
+
+void ParallelEvaluator::hessianVector(const double* x, const double* v, double* hv) {
+    if (!m_withDerivatives) throw std::logic_error("ParallelEvaluator: built without derivatives");
+    m_pool.run(m_chunks.size(), [&](size_t task, size_t worker) {
+        const Program& program = m_chunks[task].gradient;
+        std::vector<double>& values = m_values[worker];
+        std::vector<double>& tangents = m_tangents[worker];
+        values.resize(program.size());
+        tangents.resize(program.size());
+        program.runTangent(x, v, values.data(), tangents.data());
+        for (size_t k = 0; k < program.outputs().size(); ++k) m_partialVectors[task][k] = tangents[program.outputs()[k]];
+    });
+    mergeVectors(hv);
+}
+
+void ParallelEvaluator::mergeVectors(double* result) const {
+    std::fill(result, result + m_variables.size(), 0.0);
+    for (size_t c = 0; c < m_chunks.size(); ++c) {
+        const std::vector<size_t>& indices = m_chunks[c].variables;
+        for (size_t k = 0; k < indices.size(); ++k) result[indices[k]] += m_partialVectors[c][k];
+    }
+}
+
+size_t ParallelEvaluator::chunks() const {
+    return m_chunks.size();
+}
@@ -0,0 +1,157 @@
+#include "../../include/numerical/prepared_problem.hpp"
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+PreparedProblem::PreparedProblem(Node* function, const std::vector<std::string>& variables, bool withHessian)
+: m_function(function)
+, m_variables(variables)
+, m_hasHessian(withHessian)
+, m_preparationSeconds(0.0)
+{
+    prepare();
+}
+
+PreparedProblem::PreparedProblem(Node* function, const std::map<std::string, double>& x0, bool withHessian)
+: m_function(function)
+, m_hasHessian(withHessian)
+, m_preparationSeconds(0.0)
+{
+    for (const auto& [var, value] : x0) m_variables.push_back(var);
+    prepare();
+}
+
+void PreparedProblem::prepare() {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < m_variables.size(); ++i) m_index.emplace(m_variables[i], i);
+
+    // The derivative cache makes sure every symbolic partial is built exactly once
+    Differentiator differentiator;
+    for (const std::string& var : m_variables) {
+        m_gradientNodes.push_back(differentiator.partialDerivative(m_function, var));
+    }
+    if (m_hasHessian) {
+        for (Node* partial : m_gradientNodes) {
+            for (const std::string& var : m_variables) {
+                m_hessianNodes.push_back(differentiator.partialDerivative(partial, var));
+            }
+        }
+    }
+
+    m_objective = Program(m_function, m_variables);
+    m_gradient = Program(m_gradientNodes, m_variables);
+    if (m_hasHessian) m_hessian = Program(m_hessianNodes, m_variables);
+
+    m_preparationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double PreparedProblem::value(const double* x) const {
+    return m_objective.evaluate(x, m_values);
+}
+
+void PreparedProblem::gradient(const double* x, double* g) const {
+    m_gradient.evaluate(x, m_values, g);
+}
+
+void PreparedProblem::hessian(const double* x, double* h) const {
+    m_hessian.evaluate(x, m_values, h);
+}
+
+void PreparedProblem::hessianVector(const double* x, const double* v, double* hv) const {
+    m_values.resize(m_gradient.size());
+    m_tangents.resize(m_gradient.size());
+    m_gradient.runTangent(x, v, m_values.data(), m_tangents.data());
+    const std::vector<int>& outputs = m_gradient.outputs();
+    for (size_t i = 0; i < outputs.size(); ++i) hv[i] = m_tangents[outputs[i]];
+}
+
+std::vector<double> PreparedProblem::toVector(const std::map<std::string, double>& point) const {
+    std::vector<double> x(m_variables.size());
+    for (size_t i = 0; i < m_variables.size(); ++i) x[i] = point.at(m_variables[i]);
+    return x;
+}
+
+Eigen::VectorXd PreparedProblem::toEigen(const std::map<std::string, double>& point) const {
+    Eigen::VectorXd x(m_variables.size());
+    for (size_t i = 0; i < m_variables.size(); ++i) x(i) = point.at(m_variables[i]);
+    return x;
+}
+
+std::map<std::string, double> PreparedProblem::toMap(const Eigen::VectorXd& x) const {
+    std::map<std::string, double> point;
+    for (size_t i = 0; i < m_variables.size(); ++i) point[m_variables[i]] = x(i);
+    return point;
+}
+
+size_t PreparedProblem::index(const std::string& variable) const {
+    auto it = m_index.find(variable);
+    if (it == m_index.end()) throw std::invalid_argument("PreparedProblem: unknown variable " + variable);
+    return it->second;
+}
+
+std::string PreparedProblem::describe(const Eigen::VectorXd& x) const {
+    return describe(m_variables, x);
+}
+
+std::string PreparedProblem::describe(const std::vector<std::string>& variables, const Eigen::VectorXd& x) {
+    std::ostringstream text;
+    for (size_t i = 0; i < variables.size(); ++i) text << (i ? ", " : "") << variables[i] << " = " << x(i);
+    return text.str();
+}
+
+double PreparedProblem::value(const std::map<std::string, double>& point) const {
+    return value(toVector(point).data());
+}
+
+Eigen::MatrixXd PreparedProblem::gradient(const std::map<std::string, double>& point) const {
+    Eigen::MatrixXd result(1, m_variables.size());
+    gradient(toVector(point).data(), result.data());
+    return result;
+}
+
+Eigen::MatrixXd PreparedProblem::hessian(const std::map<std::string, double>& point) const {
+    // Programs write row major, Eigen stores column major
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> result(m_variables.size(), m_variables.size());
+    hessian(toVector(point).data(), result.data());
+    return result;
+}
+
+Node* PreparedProblem::function() const {
+    return m_function;
+}
+
+const std::vector<std::string>& PreparedProblem::variables() const {
+    return m_variables;
+}
+
+size_t PreparedProblem::dimension() const {
+    return m_variables.size();
+}
+
+bool PreparedProblem::hasHessian() const {
+    return m_hasHessian;
+}
+
+Node* PreparedProblem::gradientNode(size_t i) const {
+    return m_gradientNodes.at(i);
+}
+
+Node* PreparedProblem::hessianNode(size_t i, size_t j) const {
+    return m_hessianNodes.at(i * m_variables.size() + j);
+}
+
+const Program& PreparedProblem::objectiveProgram() const {
+    return m_objective;
+}
+
+const Program& PreparedProblem::gradientProgram() const {
+    return m_gradient;
+}
+
+const Program& PreparedProblem::hessianProgram() const {
+    return m_hessian;
+}
+
+double PreparedProblem::preparationSeconds() const {
+    return m_preparationSeconds;
+}
@@ -0,0 +1,192 @@
+#include "../../include/numerical/program.hpp"
+#include "../../include/syntax_tree/lowering.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+Program::Program() {}
+
+Program::Program(Node* root, const std::vector<std::string>& variables, bool lower)
+: m_variables(variables)
+{
+    compile({root}, lower);
+}
+
+Program::Program(const std::vector<Node*>& roots, const std::vector<std::string>& variables, bool lower)
+: m_variables(variables)
+{
+    compile(roots, lower);
+}
+
+void Program::compile(const std::vector<Node*>& roots, bool lower) {
+    std::map<Node*, int> compiled;
+    for (Node* root : roots) {
+        m_outputs.push_back(compileNode(lower ? Lowering::lower(root) : root, compiled));
+    }
+    m_emitted.clear();
+}
+
+double Program::apply(OpCode op, double a, double b) {
+    switch (op) {
+    case ADD: return a + b;
+    case SUB: return a - b;
+    case MUL: return a * b;
+    case DIV: return a / b;
+    case POW: return std::pow(a, b);
+    case NEG: return -a;
+    case SQRT: return std::sqrt(a);
+    case SIN: return std::sin(a);
+    case COS: return std::cos(a);
+    case TAN: return std::tan(a);
+    case SEC2: { double c = std::cos(a); return 1.0 / (c * c); }
+    case LOG: return std::log(a);
+    case EXP: return std::exp(a);
+    default: return a;
+    }
+}
+
+int Program::emit(OpCode op, int lhs, int rhs, double value) {
+    // Operations on constants are folded right away
+    if (op != CONSTANT && op != VARIABLE && m_code[lhs].op == CONSTANT && (rhs < 0 || m_code[rhs].op == CONSTANT)) {
+        value = apply(op, m_code[lhs].value, rhs < 0 ? 0.0 : m_code[rhs].value);
+        op = CONSTANT;
+        lhs = rhs = -1;
+    }
+    // a + b and b + a are the same subexpression
+    if ((op == ADD || op == MUL) && lhs > rhs) std::swap(lhs, rhs);
+
+    // Constants are keyed by their bits, NaN would break the ordering of the table
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto key = std::make_tuple(static_cast<int>(op), lhs, rhs, bits);
+    auto it = m_emitted.find(key);
+    if (it != m_emitted.end()) return it->second;
+
+    m_code.push_back(Instruction{op, lhs, rhs, value});
+    int slot = static_cast<int>(m_code.size()) - 1;
+    m_emitted.emplace(key, slot);
+    return slot;
+}
+
+int Program::compileNode(Node* node, std::map<Node*, int>& compiled) {
+    if (!node) throw std::invalid_argument("Program: missing operand (unsupported derivative?)");
+    auto it = compiled.find(node);
+    if (it != compiled.end()) return it->second;
+
+    int slot;
+    const std::string& value = node->data.value;
+    if (node->data.type == Token::NUMBER) {
+        slot = emit(CONSTANT, -1, -1, std::stod(value));
+    } else if (node->data.type == Token::VARIABLE) {
+        bool negative = value[0] == '-';
+        std::string name = negative ? value.substr(1) : value;
+        auto position = std::find(m_variables.begin(), m_variables.end(), name);
+        if (position == m_variables.end()) throw std::invalid_argument("Program: unknown variable " + name);
+        slot = emit(VARIABLE, static_cast<int>(position - m_variables.begin()), -1);
+        if (negative) slot = emit(NEG, slot, -1);
+    } else if (node->data.type == Token::OPERATOR && node->left && node->right) {
+        int lhs = compileNode(node->left, compiled);
+        int rhs = compileNode(node->right, compiled);
+        OpCode op;
+        if (value == "+") op = ADD;
+        else if (value == "-") op = SUB;
+        else if (value == "*") op = MUL;
+        else if (value == "/") op = DIV;
+        else if (value == "^") op = POW;
+        else throw std::invalid_argument("Program: unknown operator " + value);
+        slot = emit(op, lhs, rhs);
+    } else if (node->data.type == Token::OPERATOR) {
+        // Unary minus
+        slot = emit(NEG, compileNode(node->left ? node->left : node->right, compiled), -1);
+    } else {
+        int operand = compileNode(node->left, compiled);
+        OpCode op;
+        if (value == "sin") op = SIN;
+        else if (value == "cos") op = COS;
+        else if (value == "tan") op = TAN;
+        else if (value == "sec^2") op = SEC2;
+        else if (value == "log") op = LOG;
+        else if (value == "exp") op = EXP;
+        else if (value == "sqrt") op = SQRT;
+        else throw std::invalid_argument("Program: unknown function " + value);
+        slot = emit(op, operand, -1);
+    }
+    compiled.emplace(node, slot);
+    return slot;
+}
+
+void Program::run(const double* x, double* values) const {
+    const size_t count = m_code.size();
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = compute(m_code[i], x, values);
+    }
+}
+
+void Program::runTangent(const double* x, const double* v, double* values, double* tangents) const {
+    const size_t count = m_code.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Instruction& instruction = m_code[i];
+        const double r = values[i] = compute(instruction, x, values);
+        if (instruction.op == CONSTANT) { tangents[i] = 0.0; continue; }
+        if (instruction.op == VARIABLE) { tangents[i] = v[instruction.lhs]; continue; }
+        const double a = values[instruction.lhs];
+        const double da = tangents[instruction.lhs];
+        const double b = instruction.rhs < 0 ? 0.0 : values[instruction.rhs];
+        const double db = instruction.rhs < 0 ? 0.0 : tangents[instruction.rhs];
+        switch (instruction.op) {
+        case ADD: tangents[i] = da + db; break;
+        case SUB: tangents[i] = da - db; break;
+        case MUL: tangents[i] = da * b + a * db; break;
+        case DIV: tangents[i] = (da - r * db) / b; break;
+        case POW:
+            // The log term only exists when the exponent moves, which keeps a <= 0 with constant exponents finite
+            tangents[i] = (da == 0.0 ? 0.0 : b * std::pow(a, b - 1.0) * da) + (db == 0.0 ? 0.0 : r * std::log(a) * db);
+            break;
+        case NEG: tangents[i] = -da; break;
+        case SQRT: tangents[i] = da / (2.0 * r); break;
+        case SIN: tangents[i] = std::cos(a) * da; break;
+        case COS: tangents[i] = -std::sin(a) * da; break;
+        case TAN: tangents[i] = (1.0 + r * r) * da; break;
+        case SEC2: tangents[i] = 2.0 * r * std::tan(a) * da; break;
+        case LOG: tangents[i] = da / a; break;
+        case EXP: tangents[i] = r * da; break;
+        default: tangents[i] = 0.0; break;
+        }
+    }
+}
+
+double Program::evaluate(const double* x, std::vector<double>& values) const {
+    values.resize(m_code.size());
+    run(x, values.data());
+    return values[m_outputs[0]];
+}
+
+void Program::evaluate(const double* x, std::vector<double>& values, double* results) const {
+    values.resize(m_code.size());
+    run(x, values.data());
+    for (size_t k = 0; k < m_outputs.size(); ++k) results[k] = values[m_outputs[k]];
+}
+
+double Program::evaluate(const std::map<std::string, double>& point) const {
+    std::vector<double> x(m_variables.size());
+    for (size_t i = 0; i < m_variables.size(); ++i) x[i] = point.at(m_variables[i]);
+    std::vector<double> values;
+    return evaluate(x.data(), values);
+}
+
+size_t Program::size() const {
+    return m_code.size();
+}
+
+const std::vector<Program::Instruction>& Program::instructions() const {
+    return m_code;
+}
+
+const std::vector<int>& Program::outputs() const {
+    return m_outputs;
+}
+
+const std::vector<std::string>& Program::variables() const {
+    return m_variables;
+}
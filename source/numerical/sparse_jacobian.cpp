@@ -0,0 +1,76 @@
+#include "../../include/numerical/sparse_jacobian.hpp"
+#include "../../include/syntax_tree/differentiator.hpp"
+#include "../../include/syntax_tree/separability.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+SparseJacobian::SparseJacobian(const std::vector<Node*>& residuals, const std::vector<std::string>& variables)
+: m_variables(variables)
+, m_pattern(residuals.size(), variables.size())
+{
+    // Structural pattern: a residual can only depend on the variables it contains
+    Differentiator differentiator;
+    std::vector<Eigen::Triplet<double>> entries;
+    std::map<std::pair<size_t, size_t>, Node*> partials;
+    for (size_t i = 0; i < residuals.size(); ++i) {
+        for (const std::string& name : Separability::variables(residuals[i])) {
+            auto position = std::find(variables.begin(), variables.end(), name);
+            if (position == variables.end()) throw std::invalid_argument("SparseJacobian: unknown variable " + name);
+            size_t j = position - variables.begin();
+            Node* partial = differentiator.partialDerivative(residuals[i], name);
+            if (!partial) throw std::invalid_argument("SparseJacobian: cannot differentiate residual " + std::to_string(i));
+            // e.g. x - x, whose derivative simplifies away
+            if (partial->data.type == Token::NUMBER && std::stod(partial->data.value) == 0.0) continue;
+            entries.emplace_back(i, j, 1.0);
+            partials[{i, j}] = partial;
+        }
+    }
+    m_pattern.setFromTriplets(entries.begin(), entries.end());
+    m_pattern.makeCompressed();
+
+    // Outputs in compressed column order: column by column, rows ascending
+    for (Eigen::Index j = 0; j < m_pattern.outerSize(); ++j) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(m_pattern, j); it; ++it) {
+            m_partials.push_back(partials.at({static_cast<size_t>(it.row()), static_cast<size_t>(j)}));
+        }
+    }
+    m_residuals = Program(residuals, variables);
+    m_jacobian = Program(m_partials, variables);
+}
+
+void SparseJacobian::residuals(const double* x, double* r) const {
+    m_residuals.evaluate(x, m_values, r);
+}
+
+void SparseJacobian::jacobian(const double* x, Eigen::SparseMatrix<double>& jacobian) const {
+    bool samePattern = jacobian.isCompressed() && jacobian.rows() == m_pattern.rows() && jacobian.cols() == m_pattern.cols()
+        && jacobian.nonZeros() == m_pattern.nonZeros()
+        && std::equal(m_pattern.outerIndexPtr(), m_pattern.outerIndexPtr() + m_pattern.outerSize() + 1, jacobian.outerIndexPtr())
+        && std::equal(m_pattern.innerIndexPtr(), m_pattern.innerIndexPtr() + m_pattern.nonZeros(), jacobian.innerIndexPtr());
+    if (!samePattern) jacobian = m_pattern;
+    if (m_partials.empty()) return;
+    m_jacobian.evaluate(x, m_values, jacobian.valuePtr());
+}
+
+const Eigen::SparseMatrix<double>& SparseJacobian::pattern() const {
+    return m_pattern;
+}
+
+size_t SparseJacobian::rows() const {
+    return m_pattern.rows();
+}
+
+size_t SparseJacobian::cols() const {
+    return m_pattern.cols();
+}
+
+size_t SparseJacobian::nonZeros() const {
+    return m_partials.size();
+}
+
+Node* SparseJacobian::partialNode(size_t i, size_t j) const {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(m_pattern, j); it; ++it) {
+        if (static_cast<size_t>(it.row()) == i) return m_partials[&it.value() - m_pattern.valuePtr()];
+    }
+    return nullptr;
+}
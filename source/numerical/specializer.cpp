@@ -0,0 +1,91 @@
+#include "../../include/numerical/specializer.hpp"
+#include "../../include/syntax_tree/polynomial.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+Specializer::Specializer(Node* function, const std::vector<std::string>& variables, bool withHessian)
+: m_function(function)
+, m_variables(variables)
+, m_withHessian(withHessian)
+{
+}
+
+std::vector<std::string> Specializer::freeVariables(const std::map<std::string, double>& binding) const {
+    std::vector<std::string> free;
+    for (const std::string& var : m_variables) {
+        if (!binding.count(var)) free.push_back(var);
+    }
+    return free;
+}
+
+const PreparedProblem& Specializer::specialize(const std::map<std::string, double>& binding) {
+    auto it = m_specialized.find(binding);
+    if (it != m_specialized.end()) return it->second;
+
+    for (const auto& [var, value] : binding) {
+        if (std::find(m_variables.begin(), m_variables.end(), var) == m_variables.end()) {
+            throw std::invalid_argument("Specializer: unknown variable " + var);
+        }
+    }
+    return m_specialized.try_emplace(binding, bind(m_function, binding), freeVariables(binding), m_withHessian).first->second;
+}
+
+Node* Specializer::bind(Node* function, const std::map<std::string, double>& binding) {
+    std::map<Node*, Node*> bound;
+    Node* substituted = bindNode(function, binding, bound);
+    // Products and powers of the free variables whose coefficients are now known are collected here
+    return Polynomial::normalize(substituted, CostModel());
+}
+
+Node* Specializer::bindNode(Node* node, const std::map<std::string, double>& binding, std::map<Node*, Node*>& bound) {
+    if (!node) return nullptr;
+    auto memo = bound.find(node);
+    if (memo != bound.end()) return memo->second;
+
+    Node* result = node;
+    if (node->data.type == Token::VARIABLE) {
+        const std::string& value = node->data.value;
+        bool negative = value[0] == '-';
+        auto constant = binding.find(negative ? value.substr(1) : value);
+        if (constant != binding.end()) result = Node::number(negative ? -constant->second : constant->second);
+    } else if (node->data.type != Token::NUMBER) {
+        Node* left = bindNode(node->left, binding, bound);
+        Node* right = bindNode(node->right, binding, bound);
+        std::optional<double> a = Node::numberValue(left);
+        std::optional<double> b = Node::numberValue(right);
+        const std::string& op = node->data.value;
+        std::optional<double> folded;
+
+        if (node->data.type == Token::FUNCTION) {
+            if (a) folded = Token::fold(node->data, *a);
+        } else if (left && right) {
+            if (a && b) folded = Token::fold(node->data, *a, *b);
+            // Identities that the binding typically exposes, e.g. (y - 1) * x with y = 1
+            else if (op == "*" && ((a && *a == 0.0) || (b && *b == 0.0))) folded = 0.0;
+            else if ((op == "*" && a && *a == 1.0) || (op == "+" && a && *a == 0.0)) result = right;
+            else if ((op == "*" || op == "/" || op == "^") && b && *b == 1.0) result = left;
+            else if ((op == "+" || op == "-") && b && *b == 0.0) result = left;
+            else if (op == "^" && b && *b == 0.0) folded = 1.0;
+        } else if (a || b) {
+            // Unary minus
+            folded = Token::fold(node->data, a ? *a : *b);
+        }
+
+        if (folded) result = Node::number(*folded);
+        else if (result == node && (left != node->left || right != node->right)) {
+            result = new Node(node->data, left, right);
+        }
+    }
+    bound.emplace(node, result);
+    return result;
+}
+
+size_t Specializer::cacheSize() const {
+    return m_specialized.size();
+}
+
+void Specializer::clearCache() {
+    m_specialized.clear();
+}
@@ -0,0 +1,124 @@
+#include "../../include/numerical/thread_pool.hpp"
+#include <algorithm>
+
+// Pools (innermost first) whose tasks the current thread is running, to recognize nested run() calls
+struct RunningTask {
+    const ThreadPool* pool;
+    size_t worker;
+    const RunningTask* outer;
+};
+static thread_local const RunningTask* t_running = nullptr;
+
+ThreadPool::ThreadPool(size_t workers)
+: m_body(nullptr)
+, m_generation(0)
+, m_remaining(0)
+, m_stop(false)
+{
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t worker = 0; worker < workers; ++worker) m_queues.push_back(std::make_unique<Queue>());
+    for (size_t worker = 1; worker < workers; ++worker) m_threads.emplace_back(&ThreadPool::work, this, worker);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+size_t ThreadPool::size() const {
+    return m_queues.size();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t task, size_t worker)>& body) {
+    if (count == 0) return;
+    for (const RunningTask* running = t_running; running; running = running->outer) {
+        if (running->pool != this) continue;
+        // Called from one of our own tasks: the outer run() holds m_runMutex and waits for this
+        // task, so the nested tasks run inline on the calling worker (and with its scratch index)
+        for (size_t task = 0; task < count; ++task) body(task, running->worker);
+        return;
+    }
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_remaining = count;
+        m_error = nullptr;
+    }
+    // Contiguous ranges keep neighbouring tasks (and their data) on the same worker
+    const size_t workers = m_queues.size();
+    for (size_t worker = 0; worker < workers; ++worker) {
+        std::lock_guard<std::mutex> lock(m_queues[worker]->mutex);
+        for (size_t task = count * worker / workers; task < count * (worker + 1) / workers; ++task) {
+            m_queues[worker]->tasks.push_back(task);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_remaining == 0; });
+    m_body = nullptr;
+    if (m_error) std::rethrow_exception(m_error);
+}
+
+void ThreadPool::work(size_t worker) {
+    size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+        drain(worker);
+    }
+}
+
+void ThreadPool::drain(size_t worker) {
+    // The caller of run() may itself be a task of another pool
+    RunningTask running{this, worker, t_running};
+    t_running = &running;
+    size_t task;
+    while (next(worker, task)) {
+        try {
+            (*m_body)(task, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) m_error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_remaining == 0) m_done.notify_all();
+    }
+    t_running = running.outer;
+}
+
+bool ThreadPool::next(size_t worker, size_t& task) {
+    {
+        Queue& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+        Queue& victim = *m_queues[(worker + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
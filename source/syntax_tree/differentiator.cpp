@@ -1,6 +1,24 @@
 #include "../../include/syntax_tree/differentiator.hpp"
+#include "../../include/syntax_tree/separability.hpp"
 
-Differentiator::Differentiator() {}
+Differentiator::Differentiator() : m_useEGraph(false) {}
+
+void Differentiator::setEGraphSimplification(bool enabled, const EGraph::Limits& limits, const CostModel& model) {
+    m_useEGraph = enabled;
+    m_egraphLimits = limits;
+    m_costModel = model;
+    // Derivatives built with the previous settings would be served otherwise
+    clearDerivativeCache();
+}
+
+Node* Differentiator::simplifyDerivative(Node* root) {
+    // Collect polynomial pieces that simplify() cannot, e.g. x*x + 2*x*x -> 3 * x ^ 2
+    Node* simplified = Polynomial::normalize(this->simplify(root), m_costModel);
+    if (m_useEGraph && simplified) {
+        simplified = EGraph::simplify(simplified, m_egraphLimits, m_costModel);
+    }
+    return simplified;
+}
 
 Node* Differentiator::differentiate(Node* root, const std::string& var) {
     if (!root) return nullptr;
@@ -107,9 +125,11 @@ Node* Differentiator::differentiate(Node* root, const std::string& var) {
 Node* Differentiator::simplify(Node* root) {
     if (!root) return nullptr;
 
-    // Simplify subtrees first
-    root->left = simplify(root->left);
-    root->right = simplify(root->right);
+    // Simplify subtrees first, into a new node: the operands may be shared with the function or
+    // with cached derivatives, which must not change under them
+    Node* left = simplify(root->left);
+    Node* right = simplify(root->right);
+    if (left != root->left || right != root->right) root = new Node(root->data, left, right);
 
     // If both left and right nodes are numbers, it can be evaluated
     if (root->left && root->left->data.type == Token::NUMBER && 
@@ -156,7 +176,8 @@ Node* Differentiator::simplify(Node* root) {
 
     // Handle addition (+) simplification
     if (root->data.value == "+" || root->data.value == "-") {
-        if (root->left && (root->left->data.value == "0" || root->left->data.value == "0.000000")) {
+        // 0 - u is -u, not u
+        if (root->data.value == "+" && root->left && (root->left->data.value == "0" || root->left->data.value == "0.000000")) {
             return root->right;
         }
         if (root->right && (root->right->data.value == "0" || root->right->data.value == "0.000000")) {
@@ -169,13 +190,21 @@ Node* Differentiator::simplify(Node* root) {
 }
 
 
+// Binding strength of a node when printed in infix; "-" and operands are always self-contained
+static int infixPrecedence(Node* node) {
+    if (!node || node->data.type != Token::OPERATOR || !node->right || node->data.value == "-") return 4;
+    if (node->data.value == "+") return 1;
+    if (node->data.value == "*" || node->data.value == "/") return 2;
+    return 3;
+}
+
 std::string Differentiator::toInfix(Node* root) {
     if (!root) return "";
 
     // If it's a function (e.g., sin, cos), wrap the argument in parentheses
     if (root->data.type == Token::FUNCTION) {
         if (root->left) {
-            return root->data.value + toInfix(root->left);
+            return root->data.value + "(" + toInfix(root->left) + ")";
         } else {
             return root->data.value + "()";  // Handle case where left is null (uncommon)
         }
@@ -183,15 +212,27 @@ std::string Differentiator::toInfix(Node* root) {
 
     // If it's an operator, handle left and right sides
     if (root->data.type == Token::OPERATOR) {
-        std::string left = root->left ? toInfix(root->left) : "";
-        std::string right = root->right ? toInfix(root->right) : "";
+        // Unary minus (e.g. from the derivative of cos) has a single operand
+        if (!root->left || !root->right) {
+            return "(0 - " + toInfix(root->left ? root->left : root->right) + ")";
+        }
+
+        std::string left = toInfix(root->left);
+        std::string right = toInfix(root->right);
 
         // Only add parentheses when needed based on operator precedence
         if (root->data.value == "-") {
             // Use parentheses for low-precedence operations (addition, subtraction)
             return "(" + left + " " + root->data.value + " " + right + ")";
         } else {
-            // Don't use parentheses for higher precedence (multiplication, division)
+            // Operands that bind weaker than this operator, e.g. a sum under a product, need their own parentheses
+            int precedence = infixPrecedence(root);
+            if (infixPrecedence(root->left) < precedence || (root->data.value == "^" && infixPrecedence(root->left) == precedence)) {
+                left = "(" + left + ")";
+            }
+            if (infixPrecedence(root->right) < precedence || (root->data.value == "/" && infixPrecedence(root->right) == precedence)) {
+                right = "(" + right + ")";
+            }
             return left + " " + root->data.value + " " + right;
         }
     }
@@ -210,59 +251,133 @@ std::string Differentiator::toInfix(Node* root) {
 }
 
 
+size_t Differentiator::structureId(const Node* node) {
+    if (!node) return 0;
+    // Every node seen before, in this tree or an earlier one, is a single lookup
+    auto known = m_nodeIds.find(node);
+    if (known != m_nodeIds.end()) return known->second;
+    StructureKey key(node->data.type, node->data.value, structureId(node->left), structureId(node->right));
+    size_t result = m_structures.emplace(std::move(key), m_structures.size() + 1).first->second;
+    m_nodeIds.emplace(node, result);
+    return result;
+}
+
+const std::optional<Polynomial>& Differentiator::polynomialForm(Node* expression, size_t id) {
+    auto it = m_polynomials.find(id);
+    if (it == m_polynomials.end()) {
+        it = m_polynomials.emplace(id, Polynomial::fromAST(expression)).first;
+    }
+    return it->second;
+}
+
+Node* Differentiator::partialDerivative(Node* function, const std::string& var) {
+    size_t id = structureId(function);
+    auto key = std::make_pair(id, var);
+    auto it = m_partials.find(key);
+    if (it != m_partials.end()) {
+        m_cacheStatistics.hits++;
+        return it->second;
+    }
+    m_cacheStatistics.misses++;
+
+    Node* derivative;
+    const std::optional<Polynomial>& polynomial = polynomialForm(function, id);
+    if (polynomial) {
+        // Polynomials are differentiated on their normal form, and so are their derivatives later on
+        Polynomial partial = polynomial->differentiate(var);
+        derivative = partial.toAST();
+        m_polynomials.emplace(structureId(derivative), partial);
+    } else {
+        derivative = this->simplifyDerivative(this->differentiate(function, var));
+    }
+    m_partials.emplace(key, derivative);
+    return derivative;
+}
+
+double Differentiator::evaluateCached(Node* expression, const std::map<std::string, double>& variablesMap) {
+    size_t id = structureId(expression);
+    const std::optional<Polynomial>& polynomial = polynomialForm(expression, id);
+    if (polynomial) return polynomial->evaluate(variablesMap);
+
+    std::vector<std::string> variables;
+    for (const auto& [var, value] : variablesMap) variables.push_back(var);
+    auto it = m_programs.find(id);
+    if (it == m_programs.end() || it->second.variables() != variables) {
+        // Lowered and compiled straight from the tree, no infix round trip
+        m_programs[id] = Program(expression, variables);
+        m_cacheStatistics.programs++;
+        it = m_programs.find(id);
+    }
+    return it->second.evaluate(variablesMap);
+}
+
+const Differentiator::CacheStatistics& Differentiator::cacheStatistics() const {
+    return m_cacheStatistics;
+}
+
+void Differentiator::clearDerivativeCache() {
+    m_nodeIds.clear();
+    m_structures.clear();
+    m_partials.clear();
+    m_polynomials.clear();
+    m_programs.clear();
+    m_cacheStatistics = CacheStatistics();
+}
+
+
 /** @brief Computing the jacobian of the mathematical expression. 
  * Using Eigen because there are no matrices in C++, only an array of an array.
  */
 Eigen::MatrixXd Differentiator::computeJacobian(Node* function, const std::map<std::string, double>& variablesMap){
-    Token tokenizer;
     const int numVariables = variablesMap.size();
     Eigen::MatrixXd jacobian(1, numVariables); // 1 x n
 
-    // Diferrentiate the function w.r.t every variable.
+    // Diferrentiate the function w.r.t every variable (only on the first call, later calls hit the cache).
     int col = 0;
     for (const auto& [var, value] : variablesMap){
-        Node* partialDerivative = this->differentiate(function, var);
-        Node* simplifiedPartial = this->simplify(partialDerivative);
-        auto diff_expression = this->toInfix(simplifiedPartial);
-        auto tokens_differential = tokenizer.tokenize(diff_expression);
-        auto outputQueue_differential = tokenizer.ShuntingYard(tokens_differential);
-        double evaluatedPartial = tokenizer.evaluateRPN(outputQueue_differential, variablesMap);
-
-        jacobian(0,col) = evaluatedPartial;
+        Node* partial = this->partialDerivative(function, var);
+        jacobian(0,col) = this->evaluateCached(partial, variablesMap);
         col++;
-    }   
+    }
 
     return jacobian;
 }
 
-/** @brief Computing the hessian of the mathematical expression. */
+/** @brief Computing the hessian of the mathematical expression.
+ * Only the pairs of variables that appear together in some summand of the function can have a
+ * nonzero second derivative, and the Hessian is symmetric: the upper triangle of those pairs is
+ * differentiated and evaluated, the rest is mirrored or left at 0.
+ */
 Eigen::MatrixXd Differentiator::computeHessian(Node* function, const std::map<std::string, double>& variablesMap){
     const int numVariables = variablesMap.size();
-    Eigen::MatrixXd hessian(numVariables, numVariables); // n x n
-    Token tokenizer;
+    Eigen::MatrixXd hessian = Eigen::MatrixXd::Zero(numVariables, numVariables); // n x n
+
+    std::map<std::string, int> index;
+    for (const auto& [var, value] : variablesMap) index.emplace(var, index.size());
+    std::vector<std::vector<bool>> interacts(numVariables, std::vector<bool>(numVariables, false));
+    for (const auto& term : Separability::terms(function)) {
+        std::vector<int> indices;
+        for (const std::string& name : Separability::variables(term.first)) {
+            auto it = index.find(name);
+            if (it != index.end()) indices.push_back(it->second);
+        }
+        for (int a : indices) for (int b : indices) interacts[a][b] = true;
+    }
 
-    // Double differentiate the function w.r.t every variable.
     // Compute the second-order partial derivatives (Hessian matrix)
     int row = 0;
     for (const auto& [var1, value1] : variablesMap){
+        // The first derivative is built once per row, not once per entry
+        Node* firstDerivative = nullptr;
         int col = 0;
         for (const auto& [var2, value2] : variablesMap){
-            // First, compute the derivative of the function with respect to var1
-            Node* firstDerivative = this->differentiate(function, var1);
-            Node* simplifiedFirstDerivative = this->simplify(firstDerivative);
-
-            // Now, compute the derivative of the first derivative with respect to var2
-            Node* secondDerivative = this->differentiate(simplifiedFirstDerivative, var2);
-            Node* simplifiedSecondDerivative = this->simplify(secondDerivative);
-            auto diff_expression = this->toInfix(simplifiedSecondDerivative);
-            auto tokens_differential = tokenizer.tokenize(diff_expression);
-            auto outputQueue_differential = tokenizer.ShuntingYard(tokens_differential);
-
-            // Evaluate the second-order derivative at the provided variable values
-            double evaluatedPartial = tokenizer.evaluateRPN(outputQueue_differential, variablesMap);
-
-            // Assign the result to the Hessian matrix
-            hessian(row, col) = evaluatedPartial;
+            if (col >= row && interacts[row][col]) {
+                if (!firstDerivative) firstDerivative = this->partialDerivative(function, var1);
+                Node* secondDerivative = this->partialDerivative(firstDerivative, var2);
+
+                // Evaluate the second-order derivative at the provided variable values
+                hessian(row, col) = hessian(col, row) = this->evaluateCached(secondDerivative, variablesMap);
+            }
             col++;
         }
         row++;
@@ -272,10 +387,13 @@ Eigen::MatrixXd Differentiator::computeHessian(Node* function, const std::map<st
 }
 
 double Differentiator::norm(const std::map<std::string, double>& point1, const std::map<std::string, double>& point2) {
-            // Compute the differences between the x and y coordinates
-            double dx = point2.at("x") - point1.at("x");
-            double dy = point2.at("y") - point1.at("y");
+            // Compute the differences between the coordinates, variable by variable
+            double sum = 0.0;
+            for (const auto& [var, value] : point1) {
+                double difference = point2.at(var) - value;
+                sum += difference * difference;
+            }
 
             // Compute and return the Euclidean norm (distance)
-            return std::sqrt(std::pow(dx, 2) + std::pow(dy, 2));
-        }  
\ No newline at end of file
+            return std::sqrt(sum);
+        }
@@ -0,0 +1,518 @@
+#include "../../include/syntax_tree/egraph.hpp"
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+namespace {
+
+bool isOperatorSymbol(const std::string& value) {
+    return value == "+" || value == "-" || value == "*" || value == "/" || value == "^";
+}
+
+bool isFunctionSymbol(const std::string& value) {
+    return value == "sin" || value == "cos" || value == "tan" || value == "sec^2"
+        || value == "log" || value == "exp" || value == "sqrt";
+}
+
+// Split "(+ ?a (* 2 ?b))" into "(", "+", "?a", "(", "*", "2", "?b", ")", ")"
+std::vector<std::string> splitSExpression(const std::string& text) {
+    std::vector<std::string> atoms;
+    std::string current;
+    for (char c : text) {
+        if (c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c))) {
+            if (!current.empty()) {
+                atoms.push_back(current);
+                current.clear();
+            }
+            if (c == '(' || c == ')') atoms.push_back(std::string(1, c));
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) atoms.push_back(current);
+    return atoms;
+}
+
+Token::TokenData atomToToken(const std::string& atom) {
+    if (isOperatorSymbol(atom)) return Token::TokenData(Token::OPERATOR, atom);
+    if (isFunctionSymbol(atom)) return Token::TokenData(Token::FUNCTION, atom);
+    char* end = nullptr;
+    double value = std::strtod(atom.c_str(), &end);
+    if (end != atom.c_str() && *end == '\0') return Token::TokenData(Token::NUMBER, Token::numberToString(value));
+    return Token::TokenData(Token::VARIABLE, atom);
+}
+
+EGraph::Pattern parsePattern(const std::vector<std::string>& atoms, size_t& pos) {
+    if (pos >= atoms.size()) throw std::invalid_argument("EGraph: unexpected end of pattern");
+    EGraph::Pattern pattern;
+    const std::string& atom = atoms[pos++];
+    if (atom == "(") {
+        pattern.data = atomToToken(atoms.at(pos++));
+        while (pos < atoms.size() && atoms[pos] != ")") {
+            pattern.children.push_back(parsePattern(atoms, pos));
+        }
+        if (pos >= atoms.size()) throw std::invalid_argument("EGraph: unbalanced pattern");
+        pos++; // skip ")"
+    } else if (atom[0] == '?') {
+        pattern.variable = atom;
+    } else {
+        pattern.data = atomToToken(atom);
+    }
+    return pattern;
+}
+
+// Only rewrite (a^b)^c when b and c are integers, otherwise (x^2)^0.5 would become x instead of
+// |x|, and (x^0.5)^2 would become x, defined for x < 0 where the original is not
+std::function<bool(const EGraph&, const EGraph::Substitution&)> areIntegerConstants(const std::vector<std::string>& variables) {
+    return [variables](const EGraph& graph, const EGraph::Substitution& substitution) {
+        for (const std::string& variable : variables) {
+            std::optional<double> value = graph.constant(substitution.at(variable));
+            if (!value || std::floor(*value) != *value) return false;
+        }
+        return true;
+    };
+}
+
+// a/a = 1, a^b/a^c = a^(b-c) and a^b*a^c = a^(b+c) only hold where a != 0 (a/a reaches the last
+// one through div-canon, as a*a^-1), and exp(log a) = a only where a > 0: without a constant to
+// prove it, rewriting would extend the function's domain
+std::function<bool(const EGraph&, const EGraph::Substitution&)> isNonzeroConstant(const std::string& variable) {
+    return [variable](const EGraph& graph, const EGraph::Substitution& substitution) {
+        std::optional<double> value = graph.constant(substitution.at(variable));
+        return value && *value != 0.0;
+    };
+}
+
+std::function<bool(const EGraph&, const EGraph::Substitution&)> isPositiveConstant(const std::string& variable) {
+    return [variable](const EGraph& graph, const EGraph::Substitution& substitution) {
+        std::optional<double> value = graph.constant(substitution.at(variable));
+        return value && *value > 0.0;
+    };
+}
+
+} // namespace
+
+
+double CostModel::operationCost(const Token::TokenData& data, size_t arity) const {
+    switch (data.type) {
+    case Token::NUMBER: return number;
+    case Token::VARIABLE: return data.value[0] == '-' ? variable + negate : variable;
+    case Token::OPERATOR:
+        if (arity < 2) return negate;
+        if (data.value == "+" || data.value == "-") return add;
+        if (data.value == "*") return multiply;
+        if (data.value == "/") return divide;
+        return power;
+    case Token::FUNCTION:
+        if (data.value == "sin") return sin;
+        if (data.value == "cos") return cos;
+        if (data.value == "tan") return tan;
+        if (data.value == "sec^2") return sec2;
+        if (data.value == "exp") return exp;
+        if (data.value == "log") return log;
+        if (data.value == "sqrt") return sqrt;
+        return power;
+    default:
+        return 0.0;
+    }
+}
+
+double CostModel::cost(Node* root) const {
+    if (!root) return 0.0;
+    size_t arity = (root->left ? 1 : 0) + (root->right ? 1 : 0);
+    return operationCost(root->data, arity) + cost(root->left) + cost(root->right);
+}
+
+
+bool EGraph::ENode::operator<(const ENode& other) const {
+    if (data.type != other.data.type) return data.type < other.data.type;
+    if (data.value != other.data.value) return data.value < other.data.value;
+    return children < other.children;
+}
+
+EGraph::EGraph() {}
+
+int EGraph::find(int id) const {
+    while (m_parent[id] != id) id = m_parent[id];
+    return id;
+}
+
+std::optional<double> EGraph::constant(int id) const {
+    return m_constant[find(id)];
+}
+
+size_t EGraph::nodeCount() const {
+    return m_memo.size();
+}
+
+size_t EGraph::classCount() const {
+    size_t count = 0;
+    for (size_t id = 0; id < m_parent.size(); ++id) {
+        if (m_parent[id] == static_cast<int>(id)) count++;
+    }
+    return count;
+}
+
+void EGraph::canonicalize(ENode& node) const {
+    for (int& child : node.children) child = find(child);
+}
+
+// Constant folding analysis: the value of an e-node whose operands are all known constants
+std::optional<double> EGraph::fold(const ENode& node) const {
+    if (node.data.type == Token::NUMBER) return std::stod(node.data.value);
+    if (node.data.type == Token::VARIABLE) return std::nullopt;
+
+    std::vector<double> args;
+    for (int child : node.children) {
+        std::optional<double> value = m_constant[find(child)];
+        if (!value) return std::nullopt;
+        args.push_back(*value);
+    }
+
+    std::optional<double> result = args.size() == 1 ? Token::fold(node.data, args[0]) : Token::fold(node.data, args[0], args[1]);
+    if (!result || !std::isfinite(*result)) return std::nullopt;
+    return result;
+}
+
+int EGraph::addNode(ENode node) {
+    canonicalize(node);
+    auto it = m_memo.find(node);
+    if (it != m_memo.end()) return find(it->second);
+
+    int id = static_cast<int>(m_parent.size());
+    m_parent.push_back(id);
+    m_nodes.push_back({node});
+    m_constant.push_back(fold(node));
+    m_memo.emplace(node, id);
+
+    // Every class with a known value also holds the plain number, so it can be extracted for free
+    if (m_constant[id] && node.data.type != Token::NUMBER) {
+        int number = addNode(ENode{Token::TokenData(Token::NUMBER, Token::numberToString(*m_constant[id])), {}});
+        merge(id, number);
+    }
+    return find(id);
+}
+
+int EGraph::add(Node* root) {
+    std::map<Node*, int> visited;
+    std::function<int(Node*)> addTree = [&](Node* node) -> int {
+        if (!node) throw std::invalid_argument("EGraph: operator without operand");
+        auto it = visited.find(node);
+        if (it != visited.end()) return it->second;
+
+        int id;
+        if (node->data.type == Token::NUMBER) {
+            id = addNode(ENode{Token::TokenData(Token::NUMBER, Token::numberToString(std::stod(node->data.value))), {}});
+        } else if (node->data.type == Token::VARIABLE) {
+            if (node->data.value[0] == '-') {
+                // "-x" coming from the tokenizer is the negation of "x"
+                int variable = addNode(ENode{Token::TokenData(Token::VARIABLE, node->data.value.substr(1)), {}});
+                id = addNode(ENode{Token::TokenData(Token::OPERATOR, "-"), {variable}});
+            } else {
+                id = addNode(ENode{node->data, {}});
+            }
+        } else if (node->data.type == Token::OPERATOR && node->left && node->right) {
+            int left = addTree(node->left);
+            int right = addTree(node->right);
+            id = addNode(ENode{node->data, {left, right}});
+        } else {
+            // Unary minus and functions only have one operand
+            int operand = addTree(node->left ? node->left : node->right);
+            id = addNode(ENode{node->data, {operand}});
+        }
+        visited.emplace(node, id);
+        return id;
+    };
+    int id = addTree(root);
+    rebuild();
+    return find(id);
+}
+
+bool EGraph::merge(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (m_nodes[a].size() < m_nodes[b].size()) std::swap(a, b);
+
+    m_parent[b] = a;
+    m_nodes[a].insert(m_nodes[a].end(), m_nodes[b].begin(), m_nodes[b].end());
+    m_nodes[b].clear();
+    if (!m_constant[a]) m_constant[a] = m_constant[b];
+    return true;
+}
+
+/** @brief
+ * Restore the e-graph invariants after a batch of merges: equal e-nodes must live in the
+ * same e-class (congruence), and every e-class with a known value must contain that number.
+ */
+void EGraph::rebuild() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::map<ENode, int> memo;
+
+        for (int id = 0; id < static_cast<int>(m_nodes.size()); ++id) {
+            if (find(id) != id) continue;
+            std::vector<ENode> nodes = m_nodes[id];
+            for (ENode& node : nodes) {
+                canonicalize(node);
+                auto inserted = memo.emplace(node, id);
+                if (!inserted.second && find(inserted.first->second) != find(id)) {
+                    merge(inserted.first->second, id);
+                    changed = true;
+                }
+            }
+        }
+
+        for (int id = 0; id < static_cast<int>(m_nodes.size()); ++id) {
+            if (find(id) != id) continue;
+            std::set<ENode> unique;
+            for (ENode node : m_nodes[id]) {
+                canonicalize(node);
+                unique.insert(node);
+            }
+            m_nodes[id].assign(unique.begin(), unique.end());
+
+            if (!m_constant[id]) {
+                for (const ENode& node : m_nodes[id]) {
+                    if ((m_constant[id] = fold(node))) break;
+                }
+            }
+            if (m_constant[id] && m_nodes[id].front().data.type != Token::NUMBER) {
+                // NUMBER sorts first, so the class does not hold its value as a number yet
+                ENode number{Token::TokenData(Token::NUMBER, Token::numberToString(*m_constant[id])), {}};
+                auto it = memo.find(number);
+                if (it != memo.end()) {
+                    merge(it->second, id);
+                } else {
+                    m_nodes[id].insert(m_nodes[id].begin(), number);
+                    memo.emplace(number, id);
+                }
+                changed = true;
+            }
+        }
+
+        m_memo.clear();
+        for (const auto& [node, id] : memo) m_memo.emplace(node, find(id));
+    }
+}
+
+void EGraph::match(const Pattern& pattern, int id, const Substitution& substitution, std::vector<Substitution>& matches) const {
+    id = find(id);
+    if (!pattern.variable.empty()) {
+        auto it = substitution.find(pattern.variable);
+        if (it == substitution.end()) {
+            Substitution extended = substitution;
+            extended[pattern.variable] = id;
+            matches.push_back(extended);
+        } else if (find(it->second) == id) {
+            matches.push_back(substitution);
+        }
+        return;
+    }
+
+    for (const ENode& node : m_nodes[id]) {
+        if (!(node.data == pattern.data) || node.children.size() != pattern.children.size()) continue;
+        std::vector<Substitution> partial{substitution};
+        for (size_t k = 0; k < pattern.children.size() && !partial.empty(); ++k) {
+            std::vector<Substitution> next;
+            for (const Substitution& candidate : partial) {
+                match(pattern.children[k], node.children[k], candidate, next);
+            }
+            partial.swap(next);
+        }
+        matches.insert(matches.end(), partial.begin(), partial.end());
+    }
+}
+
+int EGraph::instantiate(const Pattern& pattern, const Substitution& substitution) {
+    if (!pattern.variable.empty()) return substitution.at(pattern.variable);
+    ENode node{pattern.data, {}};
+    for (const Pattern& child : pattern.children) {
+        node.children.push_back(instantiate(child, substitution));
+    }
+    return addNode(node);
+}
+
+EGraph::Report EGraph::saturate(const std::vector<Rewrite>& rules, const Limits& limits) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    Report report;
+    report.reason = ITERATION_LIMIT;
+    while (report.iterations < limits.maxIterations) {
+        // Read phase: collect every match before touching the graph
+        std::vector<std::tuple<const Rewrite*, int, Substitution>> matches;
+        bool outOfTime = false;
+        for (const Rewrite& rule : rules) {
+            if ((outOfTime = elapsed() > limits.maxSeconds)) break;
+            for (int id = 0; id < static_cast<int>(m_nodes.size()); ++id) {
+                if (find(id) != id) continue;
+                std::vector<Substitution> found;
+                match(rule.lhs, id, {}, found);
+                for (Substitution& substitution : found) {
+                    if (!rule.condition || rule.condition(*this, substitution)) {
+                        matches.emplace_back(&rule, id, std::move(substitution));
+                    }
+                }
+            }
+        }
+
+        // Write phase: add the right hand sides and merge them with the matched classes
+        size_t nodesBefore = nodeCount();
+        bool merged = false;
+        bool overBudget = false;
+        for (const auto& [rule, id, substitution] : matches) {
+            merged |= merge(id, instantiate(rule->rhs, substitution));
+            if (nodeCount() > limits.maxNodes) {
+                overBudget = true;
+                break;
+            }
+        }
+        outOfTime |= elapsed() > limits.maxSeconds;
+        rebuild();
+        report.iterations++;
+
+        if (overBudget) {
+            report.reason = NODE_LIMIT;
+            break;
+        }
+        if (!merged && nodeCount() == nodesBefore) {
+            report.reason = SATURATED;
+            break;
+        }
+        if (outOfTime) {
+            report.reason = TIME_LIMIT;
+            break;
+        }
+    }
+
+    report.nodes = nodeCount();
+    report.classes = classCount();
+    return report;
+}
+
+Node* EGraph::extract(int id, const CostModel& model) const {
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> cost(m_nodes.size(), infinity);
+    std::vector<const ENode*> best(m_nodes.size(), nullptr);
+
+    // Bellman-Ford style relaxation: a class costs as much as its cheapest e-node
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int c = 0; c < static_cast<int>(m_nodes.size()); ++c) {
+            if (find(c) != c) continue;
+            for (const ENode& node : m_nodes[c]) {
+                double total = model.operationCost(node.data, node.children.size());
+                for (int child : node.children) total += cost[find(child)];
+                if (total < cost[c]) {
+                    cost[c] = total;
+                    best[c] = &node;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    std::map<int, Node*> built;
+    std::function<Node*(int)> build = [&](int c) -> Node* {
+        c = find(c);
+        auto it = built.find(c);
+        if (it != built.end()) return it->second;
+
+        const ENode* node = best[c];
+        Node* result;
+        if (node->children.empty()) {
+            result = new Node(node->data);
+        } else if (node->children.size() == 1) {
+            result = new Node(node->data, build(node->children[0]), nullptr);
+        } else {
+            result = new Node(node->data, build(node->children[0]), build(node->children[1]));
+        }
+        built.emplace(c, result);
+        return result;
+    };
+    return build(id);
+}
+
+EGraph::Rewrite EGraph::rewrite(const std::string& name, const std::string& lhs, const std::string& rhs,
+                                std::function<bool(const EGraph&, const Substitution&)> condition) {
+    std::vector<std::string> lhsAtoms = splitSExpression(lhs);
+    std::vector<std::string> rhsAtoms = splitSExpression(rhs);
+    size_t lhsPos = 0, rhsPos = 0;
+    return Rewrite{name, parsePattern(lhsAtoms, lhsPos), parsePattern(rhsAtoms, rhsPos), condition};
+}
+
+std::vector<EGraph::Rewrite> EGraph::defaultRules() {
+    static const std::vector<Rewrite> rules = {
+        // Commutativity and associativity
+        rewrite("comm-add", "(+ ?a ?b)", "(+ ?b ?a)"),
+        rewrite("comm-mul", "(* ?a ?b)", "(* ?b ?a)"),
+        rewrite("assoc-add", "(+ (+ ?a ?b) ?c)", "(+ ?a (+ ?b ?c))"),
+        rewrite("assoc-mul", "(* (* ?a ?b) ?c)", "(* ?a (* ?b ?c))"),
+
+        // Subtraction and negation
+        rewrite("sub-canon", "(- ?a ?b)", "(+ ?a (* -1 ?b))"),
+        rewrite("sub-uncanon", "(+ ?a (* -1 ?b))", "(- ?a ?b)"),
+        rewrite("neg-canon", "(- ?a)", "(* -1 ?a)"),
+        rewrite("neg-uncanon", "(* -1 ?a)", "(- ?a)"),
+        rewrite("sub-self", "(- ?a ?a)", "0"),
+
+        // Identities
+        rewrite("add-zero", "(+ ?a 0)", "?a"),
+        rewrite("mul-one", "(* ?a 1)", "?a"),
+        rewrite("mul-zero", "(* ?a 0)", "0"),
+        rewrite("div-one", "(/ ?a 1)", "?a"),
+        rewrite("div-self", "(/ ?a ?a)", "1", isNonzeroConstant("?a")),
+        rewrite("div-canon", "(/ ?a ?b)", "(* ?a (^ ?b -1))"),
+        rewrite("div-uncanon", "(* ?a (^ ?b -1))", "(/ ?a ?b)"),
+
+        // Distributivity
+        rewrite("distribute", "(* ?a (+ ?b ?c))", "(+ (* ?a ?b) (* ?a ?c))"),
+        rewrite("factor", "(+ (* ?a ?b) (* ?a ?c))", "(* ?a (+ ?b ?c))"),
+
+        // Power laws
+        rewrite("pow-one", "(^ ?a 1)", "?a"),
+        rewrite("pow-zero", "(^ ?a 0)", "1"),
+        rewrite("pow-square", "(^ ?a 2)", "(* ?a ?a)"),
+        rewrite("square-pow", "(* ?a ?a)", "(^ ?a 2)"),
+        rewrite("pow-mul", "(* (^ ?a ?b) (^ ?a ?c))", "(^ ?a (+ ?b ?c))", isNonzeroConstant("?a")),
+        rewrite("pow-mul-base", "(* ?a (^ ?a ?b))", "(^ ?a (+ ?b 1))", isNonzeroConstant("?a")),
+        rewrite("pow-div", "(/ (^ ?a ?b) (^ ?a ?c))", "(^ ?a (- ?b ?c))", isNonzeroConstant("?a")),
+        rewrite("pow-pow", "(^ (^ ?a ?b) ?c)", "(^ ?a (* ?b ?c))", areIntegerConstants({"?b", "?c"})),
+        rewrite("pow-recip", "(^ ?a -1)", "(/ 1 ?a)"),
+
+        // Trigonometric identities
+        rewrite("pythagoras", "(+ (^ (sin ?a) 2) (^ (cos ?a) 2))", "1"),
+        rewrite("double-angle", "(* 2 (* (sin ?a) (cos ?a)))", "(sin (* 2 ?a))"),
+        rewrite("tan-def", "(/ (sin ?a) (cos ?a))", "(tan ?a)"),
+        rewrite("sec2-tan", "(sec^2 ?a)", "(+ 1 (^ (tan ?a) 2))"),
+        rewrite("sec2-cos", "(/ 1 (^ (cos ?a) 2))", "(sec^2 ?a)"),
+        rewrite("sin-odd", "(sin (* -1 ?a))", "(* -1 (sin ?a))"),
+        rewrite("cos-even", "(cos (* -1 ?a))", "(cos ?a)"),
+
+        // Exponential and logarithm
+        rewrite("exp-add", "(* (exp ?a) (exp ?b))", "(exp (+ ?a ?b))"),
+        rewrite("log-exp", "(log (exp ?a))", "?a"),
+        rewrite("exp-log", "(exp (log ?a))", "?a", isPositiveConstant("?a")),
+    };
+    return rules;
+}
+
+Node* EGraph::simplify(Node* root, const Limits& limits, const CostModel& model, Report* report) {
+    if (!root) return nullptr;
+
+    EGraph graph;
+    int id = graph.add(root);
+    Report result = graph.saturate(defaultRules(), limits);
+    if (report) *report = result;
+
+    // Keep the original tree when saturation did not find anything cheaper
+    Node* best = graph.extract(id, model);
+    return model.cost(best) < model.cost(root) ? best : root;
+}
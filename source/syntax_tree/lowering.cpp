@@ -0,0 +1,70 @@
+#include "../../include/syntax_tree/lowering.hpp"
+#include <cmath>
+#include <optional>
+
+static Node* makeOperator(const std::string& op, Node* left, Node* right) {
+    return new Node(Token::TokenData(Token::OPERATOR, op), left, right);
+}
+
+static Node* makeFunction(const std::string& name, Node* argument) {
+    return new Node(Token::TokenData(Token::FUNCTION, name), argument, nullptr);
+}
+
+Node* Lowering::lower(Node* root) {
+    std::map<Node*, Node*> lowered;
+    return lowerNode(root, lowered);
+}
+
+// x^n with ceil(log2 n) squarings plus one multiplication per set bit, the base stays shared
+Node* Lowering::powerChain(Node* base, unsigned int exponent) {
+    Node* result = nullptr;
+    Node* square = base;
+    while (exponent > 0) {
+        if (exponent & 1) result = result ? makeOperator("*", result, square) : square;
+        exponent >>= 1;
+        if (exponent > 0) square = makeOperator("*", square, square);
+    }
+    return result;
+}
+
+Node* Lowering::lowerNode(Node* node, std::map<Node*, Node*>& lowered) {
+    if (!node) return nullptr;
+    auto it = lowered.find(node);
+    if (it != lowered.end()) return it->second;
+
+    Node* left = lowerNode(node->left, lowered);
+    Node* right = lowerNode(node->right, lowered);
+    Node* result = nullptr;
+
+    if (node->data.type == Token::OPERATOR && left && right) {
+        const std::string& op = node->data.value;
+        std::optional<double> constant = Node::numberValue(right);
+
+        if (op == "^" && constant) {
+            double exponent = *constant;
+            if (std::floor(exponent) == exponent && std::fabs(exponent) <= MAX_EXPANDED_POWER) {
+                if (exponent == 0) {
+                    result = new Node(Token::TokenData(Token::NUMBER, "1"));
+                } else {
+                    Node* chain = powerChain(left, static_cast<unsigned int>(std::fabs(exponent)));
+                    result = exponent > 0 ? chain : makeOperator("/", new Node(Token::TokenData(Token::NUMBER, "1")), chain);
+                }
+            } else if (exponent == 0.5) {
+                result = makeFunction("sqrt", left);
+            } else if (exponent == -0.5) {
+                result = makeOperator("/", new Node(Token::TokenData(Token::NUMBER, "1")), makeFunction("sqrt", left));
+            }
+        } else if (op == "/" && constant && *constant != 0 && std::isfinite(1.0 / *constant)) {
+            result = makeOperator("*", left, Node::number(1.0 / *constant));
+        } else if (op == "*" && left->data.type == Token::FUNCTION && left->data.value == "exp"
+                   && right->data.type == Token::FUNCTION && right->data.value == "exp") {
+            result = makeFunction("exp", makeOperator("+", left->left, right->left));
+        }
+    }
+
+    if (!result) {
+        result = (left == node->left && right == node->right) ? node : new Node(node->data, left, right);
+    }
+    lowered.emplace(node, result);
+    return result;
+}
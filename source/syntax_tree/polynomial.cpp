@@ -0,0 +1,295 @@
+#include "../../include/syntax_tree/polynomial.hpp"
+#include "../../include/syntax_tree/separability.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+
+// x^n by repeated squaring
+static double integerPower(double base, int exponent) {
+    double result = 1.0;
+    while (exponent > 0) {
+        if (exponent & 1) result *= base;
+        base *= base;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+Polynomial::Polynomial() {}
+
+Polynomial::Polynomial(const std::vector<std::string>& variables) : m_variables(variables) {}
+
+Polynomial Polynomial::constant(const std::vector<std::string>& variables, double value) {
+    Polynomial result(variables);
+    result.addTerm(Monomial(variables.size(), 0), value);
+    return result;
+}
+
+Polynomial Polynomial::variable(const std::vector<std::string>& variables, size_t index) {
+    Polynomial result(variables);
+    Monomial monomial(variables.size(), 0);
+    monomial[index] = 1;
+    result.addTerm(monomial, 1.0);
+    return result;
+}
+
+void Polynomial::addTerm(const Monomial& monomial, double coefficient) {
+    double& value = m_terms[monomial];
+    value += coefficient;
+    if (value == 0.0) m_terms.erase(monomial);
+}
+
+std::optional<Polynomial> Polynomial::fromAST(Node* root) {
+    return fromAST(root, Separability::variables(root));
+}
+
+std::optional<Polynomial> Polynomial::fromNode(Node* node, const std::optional<Polynomial>& left,
+                                               const std::optional<Polynomial>& right,
+                                               const std::vector<std::string>& variables) {
+    if (node->data.type == Token::NUMBER) {
+        return constant(variables, std::stod(node->data.value));
+    }
+
+    if (node->data.type == Token::VARIABLE) {
+        bool negative = node->data.value[0] == '-';
+        std::string name = negative ? node->data.value.substr(1) : node->data.value;
+        auto it = std::find(variables.begin(), variables.end(), name);
+        if (it == variables.end()) return std::nullopt;
+        Polynomial result = variable(variables, it - variables.begin());
+        return negative ? result * -1.0 : result;
+    }
+
+    if (node->data.type != Token::OPERATOR) return std::nullopt; // sin, exp, ... are not polynomials
+
+    // Unary minus
+    if (!node->left || !node->right) {
+        const std::optional<Polynomial>& operand = node->left ? left : right;
+        if (!operand) return std::nullopt;
+        return *operand * -1.0;
+    }
+    if (!left || !right) return std::nullopt;
+
+    const std::string& op = node->data.value;
+    std::optional<Polynomial> result;
+    if (op == "+") result = *left + *right;
+    else if (op == "-") result = *left - *right;
+    else if (op == "*") result = *left * *right;
+    else if (op == "/") {
+        // Only division by a nonzero constant keeps it a polynomial
+        if (!right->isConstant() || right->m_terms.empty()) return std::nullopt;
+        result = *left * (1.0 / right->m_terms.begin()->second);
+    }
+    else if (op == "^") {
+        // Only constant, non-negative integer exponents
+        if (!right->isConstant()) return std::nullopt;
+        double exponent = right->m_terms.empty() ? 0.0 : right->m_terms.begin()->second;
+        if (exponent < 0 || std::floor(exponent) != exponent || exponent > 64) return std::nullopt;
+        if (left->size() > 1 && exponent > 1 && std::pow(static_cast<double>(left->size()), exponent) > 4.0 * MAX_TERMS) {
+            return std::nullopt;
+        }
+        result = left->pow(static_cast<unsigned int>(exponent));
+    }
+    if (!result || result->size() > MAX_TERMS) return std::nullopt;
+    return result;
+}
+
+std::optional<Polynomial> Polynomial::fromAST(Node* root, const std::vector<std::string>& variables) {
+    std::function<std::optional<Polynomial>(Node*)> convert = [&](Node* node) -> std::optional<Polynomial> {
+        if (!node) return std::nullopt;
+        if (node->data.type != Token::OPERATOR) return fromNode(node, std::nullopt, std::nullopt, variables);
+
+        // Stop at the first operand that is not a polynomial
+        std::optional<Polynomial> left = convert(node->left);
+        if (node->left && node->right && !left) return std::nullopt;
+        std::optional<Polynomial> right = convert(node->right);
+        return fromNode(node, left, right, variables);
+    };
+    return convert(root);
+}
+
+Node* Polynomial::normalize(Node* root, const CostModel& model) {
+    if (!root) return nullptr;
+    const std::vector<std::string> variables = Separability::variables(root);
+
+    // One bottom-up pass: every node's polynomial is built from its operands' ones. A polynomial
+    // subtree is left to its parent, which may be a bigger polynomial; the largest ones are
+    // replaced by their normal form where that is cheaper. Nothing in the shared input tree changes.
+    struct Converted {
+        std::optional<Polynomial> polynomial;
+        Node* node;
+    };
+    auto canonical = [&model](const Converted& converted) {
+        if (!converted.polynomial) return converted.node;
+        Node* normal = converted.polynomial->toAST();
+        return model.cost(normal) < model.cost(converted.node) ? normal : converted.node;
+    };
+    std::function<Converted(Node*)> convert = [&](Node* node) -> Converted {
+        if (!node) return {std::nullopt, nullptr};
+        Converted left = convert(node->left);
+        Converted right = convert(node->right);
+        std::optional<Polynomial> polynomial = fromNode(node, left.polynomial, right.polynomial, variables);
+        if (polynomial) return {std::move(polynomial), node};
+
+        Node* leftNode = canonical(left);
+        Node* rightNode = canonical(right);
+        if (leftNode == node->left && rightNode == node->right) return {std::nullopt, node};
+        return {std::nullopt, new Node(node->data, leftNode, rightNode)};
+    };
+    return canonical(convert(root));
+}
+
+Node* Polynomial::toAST() const {
+    Node* sum = nullptr;
+    // Highest degree terms first, the way polynomials are usually written
+    for (auto it = m_terms.rbegin(); it != m_terms.rend(); ++it) {
+        const Monomial& monomial = it->first;
+        double coefficient = it->second;
+        bool subtract = sum && coefficient < 0;
+        if (subtract) coefficient = -coefficient;
+
+        Node* term = nullptr;
+        for (size_t i = 0; i < m_variables.size(); ++i) {
+            if (monomial[i] == 0) continue;
+            Node* factor = new Node(Token::TokenData(Token::VARIABLE, m_variables[i]));
+            if (monomial[i] > 1) {
+                factor = new Node(Token::TokenData(Token::OPERATOR, "^"), factor,
+                                  new Node(Token::TokenData(Token::NUMBER, std::to_string(monomial[i]))));
+            }
+            term = term ? new Node(Token::TokenData(Token::OPERATOR, "*"), term, factor) : factor;
+        }
+        if (!term) {
+            term = new Node(Token::TokenData(Token::NUMBER, Token::numberToString(coefficient)));
+        } else if (coefficient != 1.0) {
+            term = new Node(Token::TokenData(Token::OPERATOR, "*"),
+                            new Node(Token::TokenData(Token::NUMBER, Token::numberToString(coefficient))), term);
+        }
+
+        if (!sum) sum = term;
+        else sum = new Node(Token::TokenData(Token::OPERATOR, subtract ? "-" : "+"), sum, term);
+    }
+    return sum ? sum : new Node(Token::TokenData(Token::NUMBER, "0"));
+}
+
+Polynomial Polynomial::differentiate(const std::string& var) const {
+    auto it = std::find(m_variables.begin(), m_variables.end(), var);
+    if (it == m_variables.end()) return Polynomial(m_variables);
+    return differentiate(it - m_variables.begin());
+}
+
+Polynomial Polynomial::differentiate(size_t index) const {
+    Polynomial result(m_variables);
+    for (const auto& [monomial, coefficient] : m_terms) {
+        if (monomial[index] == 0) continue;
+        Monomial derived = monomial;
+        derived[index]--;
+        result.addTerm(derived, coefficient * monomial[index]);
+    }
+    return result;
+}
+
+/** @brief
+ * Horner scheme in one variable over a range of terms that share the exponents of all
+ * previous variables. The terms are sorted lexicographically, so the ones with the same
+ * exponent of this variable are contiguous and become the (recursively evaluated)
+ * coefficients of p = c_k x^k + ... + c_0 = ((c_k x^(k-j) + c_j) ...) x^m.
+ */
+double Polynomial::horner(std::map<Monomial, double>::const_iterator first,
+                          std::map<Monomial, double>::const_iterator last,
+                          size_t variable, const double* values) const {
+    if (variable == m_variables.size()) return first->second;
+
+    double result = 0.0;
+    int previous = -1;
+    auto groupEnd = last;
+    while (groupEnd != first) {
+        auto groupBegin = std::prev(groupEnd);
+        int exponent = groupBegin->first[variable];
+        while (groupBegin != first && std::prev(groupBegin)->first[variable] == exponent) --groupBegin;
+
+        double coefficient = horner(groupBegin, groupEnd, variable + 1, values);
+        if (previous < 0) result = coefficient;
+        else result = result * integerPower(values[variable], previous - exponent) + coefficient;
+        previous = exponent;
+        groupEnd = groupBegin;
+    }
+    return result * integerPower(values[variable], previous);
+}
+
+double Polynomial::evaluate(const double* values) const {
+    if (m_terms.empty()) return 0.0;
+    return horner(m_terms.begin(), m_terms.end(), 0, values);
+}
+
+double Polynomial::evaluate(const std::map<std::string, double>& point) const {
+    std::vector<double> values(m_variables.size());
+    for (size_t i = 0; i < m_variables.size(); ++i) values[i] = point.at(m_variables[i]);
+    return evaluate(values.data());
+}
+
+int Polynomial::degree() const {
+    int result = 0;
+    for (const auto& [monomial, coefficient] : m_terms) {
+        int total = 0;
+        for (int exponent : monomial) total += exponent;
+        result = std::max(result, total);
+    }
+    return result;
+}
+
+size_t Polynomial::size() const {
+    return m_terms.size();
+}
+
+bool Polynomial::isConstant() const {
+    return m_terms.empty() || (m_terms.size() == 1 && degree() == 0);
+}
+
+const std::vector<std::string>& Polynomial::variables() const {
+    return m_variables;
+}
+
+const std::map<Polynomial::Monomial, double>& Polynomial::terms() const {
+    return m_terms;
+}
+
+Polynomial Polynomial::operator+(const Polynomial& other) const {
+    Polynomial result = *this;
+    for (const auto& [monomial, coefficient] : other.m_terms) result.addTerm(monomial, coefficient);
+    return result;
+}
+
+Polynomial Polynomial::operator-(const Polynomial& other) const {
+    Polynomial result = *this;
+    for (const auto& [monomial, coefficient] : other.m_terms) result.addTerm(monomial, -coefficient);
+    return result;
+}
+
+Polynomial Polynomial::operator*(const Polynomial& other) const {
+    Polynomial result(m_variables);
+    for (const auto& [left, a] : m_terms) {
+        for (const auto& [right, b] : other.m_terms) {
+            Monomial product = left;
+            for (size_t i = 0; i < product.size(); ++i) product[i] += right[i];
+            result.addTerm(product, a * b);
+        }
+    }
+    return result;
+}
+
+Polynomial Polynomial::operator*(double factor) const {
+    Polynomial result(m_variables);
+    for (const auto& [monomial, coefficient] : m_terms) result.addTerm(monomial, coefficient * factor);
+    return result;
+}
+
+Polynomial Polynomial::pow(unsigned int exponent) const {
+    Polynomial result = constant(m_variables, 1.0);
+    Polynomial base = *this;
+    while (exponent > 0) {
+        if (exponent & 1) result = result * base;
+        exponent >>= 1;
+        if (exponent > 0) base = base * base;
+    }
+    return result;
+}
@@ -0,0 +1,117 @@
+#include "../../include/syntax_tree/separability.hpp"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <set>
+#include <unordered_set>
+
+static Node* makeOperator(const std::string& op, Node* left, Node* right) {
+    return new Node(Token::TokenData(Token::OPERATOR, op), left, right);
+}
+
+std::vector<std::pair<Node*, bool>> Separability::terms(Node* root) {
+    std::vector<std::pair<Node*, bool>> terms;
+    std::vector<std::pair<Node*, bool>> stack{{root, false}};
+    while (!stack.empty()) {
+        auto [node, negative] = stack.back();
+        stack.pop_back();
+        const std::string& op = node->data.value;
+        if (node->data.type == Token::OPERATOR && node->left && node->right && (op == "+" || op == "-")) {
+            stack.push_back({node->right, op == "-" ? !negative : negative});
+            stack.push_back({node->left, negative});
+        } else {
+            terms.push_back({node, negative});
+        }
+    }
+    return terms;
+}
+
+// Added pairwise, so a component with many terms does not become one very deep chain
+Node* Separability::sum(const std::vector<std::pair<Node*, bool>>& terms) {
+    std::vector<Node*> level;
+    for (const auto& [term, negative] : terms) {
+        level.push_back(negative ? makeOperator("-", new Node(Token::TokenData(Token::NUMBER, "0")), term) : term);
+    }
+    while (level.size() > 1) {
+        std::vector<Node*> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) next.push_back(makeOperator("+", level[i], level[i + 1]));
+        if (level.size() % 2) next.push_back(level.back());
+        level.swap(next);
+    }
+    return level[0];
+}
+
+std::vector<std::string> Separability::variables(Node* root) {
+    std::set<std::string> names;
+    std::unordered_set<Node*> visited;
+    std::vector<Node*> stack{root};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (!node || !visited.insert(node).second) continue;
+        if (node->data.type == Token::VARIABLE) {
+            const std::string& value = node->data.value;
+            names.insert(value[0] == '-' ? value.substr(1) : value);
+        }
+        stack.push_back(node->left);
+        stack.push_back(node->right);
+    }
+    return std::vector<std::string>(names.begin(), names.end());
+}
+
+Separability::Decomposition Separability::decompose(Node* root) {
+    std::vector<std::pair<Node*, bool>> terms = Separability::terms(root);
+    std::vector<std::vector<std::string>> termVariables;
+    std::map<std::string, size_t> index;
+    for (const auto& term : terms) {
+        termVariables.push_back(variables(term.first));
+        for (const std::string& name : termVariables.back()) index.emplace(name, index.size());
+    }
+
+    // Union-find over the variables, every term joins all of its variables
+    std::vector<size_t> parent(index.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t v) {
+        while (parent[v] != v) v = parent[v] = parent[parent[v]];
+        return v;
+    };
+    for (const std::vector<std::string>& names : termVariables) {
+        for (size_t k = 1; k < names.size(); ++k) {
+            size_t a = find(index[names[0]]), b = find(index[names[k]]);
+            if (a != b) parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    // Components in the order of their first (smallest) variable
+    std::map<std::string, size_t> componentOf;
+    std::map<size_t, size_t> componentOfRoot;
+    std::vector<std::vector<std::string>> componentVariables;
+    for (const auto& [name, id] : index) {
+        size_t rootId = find(id);
+        auto it = componentOfRoot.find(rootId);
+        if (it == componentOfRoot.end()) {
+            it = componentOfRoot.emplace(rootId, componentVariables.size()).first;
+            componentVariables.emplace_back();
+        }
+        componentVariables[it->second].push_back(name);
+        componentOf[name] = it->second;
+    }
+    std::sort(componentVariables.begin(), componentVariables.end());
+    for (size_t c = 0; c < componentVariables.size(); ++c) {
+        for (const std::string& name : componentVariables[c]) componentOf[name] = c;
+    }
+
+    std::vector<std::vector<std::pair<Node*, bool>>> componentTerms(componentVariables.size());
+    std::vector<std::pair<Node*, bool>> constantTerms;
+    for (size_t t = 0; t < terms.size(); ++t) {
+        if (termVariables[t].empty()) constantTerms.push_back(terms[t]);
+        else componentTerms[componentOf[termVariables[t][0]]].push_back(terms[t]);
+    }
+
+    Decomposition decomposition;
+    for (size_t c = 0; c < componentVariables.size(); ++c) {
+        decomposition.components.push_back({componentVariables[c], sum(componentTerms[c]), componentTerms[c].size()});
+    }
+    decomposition.constant = constantTerms.empty() ? nullptr : sum(constantTerms);
+    return decomposition;
+}
@@ -1,4 +1,8 @@
 #include "../../include/tokenize/token.hpp"
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
 #ifndef GOLDEN_NUMBER
 #define GOLDEN_NUMBER 0.618033988749895
 #endif
@@ -18,8 +22,25 @@ std::map<std::string, std::function<double(double)>> functions = {
     {"tan", [](double a) { return std::tan(a); }},
     {"log", [](double a) { return std::log(a); }},
     {"exp", [](double a) { return std::exp(a); }},
+    {"sqrt", [](double a) { return std::sqrt(a); }},
+    {"sec^2", [](double a) { return 1.0 / (std::cos(a) * std::cos(a)); }},
 };
 
+std::optional<double> Token::fold(const TokenData& data, double a) {
+    if (data.type == OPERATOR && data.value == "-") return -a;
+    if (data.type != FUNCTION) return std::nullopt;
+    auto function = functions.find(data.value);
+    if (function == functions.end()) return std::nullopt;
+    return function->second(a);
+}
+
+std::optional<double> Token::fold(const TokenData& data, double a, double b) {
+    if (data.type != OPERATOR) return std::nullopt;
+    auto op = operators.find(data.value);
+    if (op == operators.end()) return std::nullopt;
+    return op->second(a, b);
+}
+
 Token::Token(){}
 Token::~Token(){}
 
@@ -236,19 +257,23 @@ output:
     - function minima.
 */
 std::pair<double,double> Token::golden_section(std::queue<Token::TokenData> outputQueue, double a, double b, double e, const char* variableName){
+    return golden_section([&](double value) {
+        std::map<std::string, double> point;
+        point[variableName] = value; // This is where it might be a hussle; because these methods are for functions with only one variable..
+        return evaluateRPN(outputQueue, point);
+    }, a, b, e);
+}
+
+std::pair<double,double> Token::golden_section(const std::function<double(double)>& function, double a, double b, double e){
     double d = b - a;
     double x1, x2, f_x1, f_x2;
     while(b-a > e){
         d = GOLDEN_NUMBER * d;
         x1 = b - d;
         x2 = a + d;
-        std::map<std::string, double> x1_map;
-        std::map<std::string, double> x2_map;
-        x1_map[variableName] = x1;
-        x2_map[variableName] = x2; // This is where it might be a hussle; because these methods are for functions with only one variable..
 
-        f_x1 = evaluateRPN(outputQueue, x1_map);
-        f_x2 = evaluateRPN(outputQueue, x2_map);
+        f_x1 = function(x1);
+        f_x2 = function(x2);
 
         if (f_x1 <= f_x2){
             b = x2;
@@ -298,6 +323,92 @@ std::pair<double,double> Token::fibonacci_series(std::queue<Token::TokenData> ou
     return {a,b};
 }
 
+/**
+@brief: Brent's method with automatic bracketing.
+inputs:
+    - function = any 1-D function, e.g. a LineRestriction
+    - a, b = two starting points, they do not need to bracket the minimum
+    - e = tolerance on the final interval
+    - maxEvaluations = budget for the bracket and the search together
+output:
+    - the lowest point found, its value and the number of evaluations.
+*/
+Token::Minimum Token::brent(const std::function<double(double)>& function, double a, double b, double e, size_t maxEvaluations){
+    const double GROW = 1 + GOLDEN_NUMBER;    // geometric expansion of the bracket
+    const double SHRINK = 1 - GOLDEN_NUMBER;  // the golden section step
+    size_t evaluations = 2;
+    double f_a = function(a), f_b = function(b);
+    // Walk downhill from a through b, growing the step, until the value goes up again
+    if (f_b > f_a){
+        std::swap(a, b);
+        std::swap(f_a, f_b);
+    }
+    double c = b + GROW*(b - a);
+    double f_c = function(c);
+    evaluations++;
+    while (f_c < f_b && evaluations < maxEvaluations){
+        a = b; f_a = f_b;
+        b = c; f_b = f_c;
+        c = b + GROW*(b - a);
+        f_c = function(c);
+        evaluations++;
+    }
+    if (f_c < f_b) return {c, f_c, evaluations}; // still going down when the budget ran out
+
+    // Brent on [lower, upper] around b: x is the best point, w the second best, v the previous w
+    double lower = std::min(a, c), upper = std::max(a, c);
+    double x = b, w = b, v = b, f_x = f_b, f_w = f_b, f_v = f_b;
+    double d = 0.0, previous = 0.0;
+    while (evaluations < maxEvaluations){
+        double middle = (lower + upper)/2;
+        double tol1 = 1.5e-8*std::fabs(x) + e/4, tol2 = 2*tol1;
+        if (std::fabs(x - middle) <= tol2 - (upper - lower)/2) break;
+        bool golden = true;
+        if (std::fabs(previous) > tol1){
+            // Parabola through x, w and v
+            double r = (x - w)*(f_x - f_v);
+            double q = (x - v)*(f_x - f_w);
+            double p = (x - v)*q - (x - w)*r;
+            q = 2*(q - r);
+            if (q > 0) p = -p;
+            q = std::fabs(q);
+            double older = previous;
+            previous = d;
+            // Accepted only inside the interval and if it moves less than half the step before last
+            if (std::fabs(p) < std::fabs(q*older/2) && p > q*(lower - x) && p < q*(upper - x)){
+                d = p/q;
+                double u = x + d;
+                if (u - lower < tol2 || upper - u < tol2) d = std::copysign(tol1, middle - x);
+                golden = false;
+            }
+        }
+        if (golden){
+            previous = (x >= middle) ? lower - x : upper - x;
+            d = SHRINK*previous;
+        }
+        double u = std::fabs(d) >= tol1 ? x + d : x + std::copysign(tol1, d);
+        double f_u = function(u);
+        evaluations++;
+        if (f_u <= f_x){
+            if (u >= x) lower = x; else upper = x;
+            v = w; f_v = f_w;
+            w = x; f_w = f_x;
+            x = u; f_x = f_u;
+        }
+        else{
+            if (u < x) lower = u; else upper = u;
+            if (f_u <= f_w || w == x){
+                v = w; f_v = f_w;
+                w = u; f_w = f_u;
+            }
+            else if (f_u <= f_v || v == x || v == w){
+                v = u; f_v = f_u;
+            }
+        }
+    }
+    return {x, f_x, evaluations};
+}
+
 // Helper function to replace all occurrences of a substring in a string
 std::string Token::replace_all(std::string& str, const std::string& from, const std::string& to) {
     size_t start_pos = 0;
@@ -307,3 +418,34 @@ std::string Token::replace_all(std::string& str, const std::string& from, const
     }
     return str;
 }
+
+
+// Shortest decimal text that reads back to exactly the same double (std::to_string keeps only 6 decimals)
+std::string Token::numberToString(double value) {
+    // strtod rather than stod, which throws on subnormal values
+    auto readsBack = [value](const std::string& text) { return std::strtod(text.c_str(), nullptr) == value; };
+    std::ostringstream stream;
+    stream << std::setprecision(15) << value;
+    if (!readsBack(stream.str())) {
+        stream.str("");
+        stream << std::setprecision(17) << value;
+    }
+    // The tokenizer does not understand exponents, so fall back to plain decimals, with as many
+    // as 15 (or 17) significant digits need at this magnitude: 1e-25 must not become 0
+    if (stream.str().find('e') != std::string::npos) {
+        int exponent = static_cast<int>(std::floor(std::log10(std::fabs(value))));
+        std::string text;
+        for (int digits : {15, 17}) {
+            stream.str("");
+            stream << std::fixed << std::setprecision(std::max(0, digits - 1 - exponent)) << value;
+            text = stream.str();
+            if (text.find('.') != std::string::npos) {
+                text.erase(text.find_last_not_of('0') + 1);
+                if (text.back() == '.') text.pop_back();
+            }
+            if (readsBack(text)) break;
+        }
+        return text;
+    }
+    return stream.str();
+}
\ No newline at end of file